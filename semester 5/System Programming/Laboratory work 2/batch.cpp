@@ -0,0 +1,175 @@
+#include "batch.h"
+#include "output_writer.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <dirent.h>
+#include <glob.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+namespace batch {
+
+static bool hasSourceExtension(const char* name) {
+    size_t length = std::strlen(name);
+    return length > 3 && strcasecmp(name + length - 3, ".vb") == 0;
+}
+
+static void collectDirectory(const std::string& directory, std::vector<std::string>& out) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        std::cerr << "Error: Cannot read directory " << directory << std::endl;
+        return;
+    }
+
+    while (const dirent* entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        std::string path = directory + "/" + entry->d_name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) {
+            continue;
+        }
+        if (S_ISDIR(info.st_mode)) {
+            collectDirectory(path, out);
+        } else if (S_ISREG(info.st_mode) && hasSourceExtension(entry->d_name)) {
+            out.push_back(path);
+        }
+    }
+    closedir(dir);
+}
+
+std::vector<std::string> collectSources(const std::vector<std::string>& inputs) {
+    std::vector<std::string> files;
+
+    for (const auto& input : inputs) {
+        struct stat info;
+        if (stat(input.c_str(), &info) == 0) {
+            if (S_ISDIR(info.st_mode)) {
+                std::string directory = input;
+                while (directory.size() > 1 && directory.back() == '/') {
+                    directory.pop_back();
+                }
+                size_t first = files.size();
+                collectDirectory(directory, files);
+                std::sort(files.begin() + first, files.end());
+            } else {
+                files.push_back(input);
+            }
+            continue;
+        }
+
+        // glob() returns its matches sorted
+        glob_t matches;
+        if (glob(input.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) {
+                files.push_back(matches.gl_pathv[i]);
+            }
+        } else {
+            // Let the lexer report it like any other unreadable file
+            files.push_back(input);
+        }
+        globfree(&matches);
+    }
+
+    return files;
+}
+
+std::vector<FileResult> lexFiles(const std::vector<std::string>& files, size_t threadCount) {
+    std::vector<FileResult> results(files.size());
+
+    // Files are handed out one at a time, so a few large files do not hold
+    // up the threads working through the small ones
+    ThreadPool pool(threadCount);
+    pool.parallelFor(files.size(), [&](size_t index) {
+        FileResult& result = results[index];
+        result = FileResult{files[index], false, 0, 0, {}};
+
+        Lexer lexer(files[index]);
+        if (!lexer.isOpen()) {
+            return;
+        }
+        result.opened = true;
+
+        for (const Token& token : lexer) {
+            if (token.type == TokenType::END_OF_FILE) {
+                result.bytes = token.position;
+                break;
+            }
+            result.tokens++;
+            result.byType[static_cast<size_t>(token.type)]++;
+        }
+    });
+
+    return results;
+}
+
+static void writeRate(OutputWriter& out, double value) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.1f", value);
+    out.write(std::string_view(text, static_cast<size_t>(length)));
+}
+
+void printReport(const std::vector<FileResult>& results, double seconds, OutputWriter& out) {
+    size_t totalTypes[TYPE_COUNT] = {};
+    size_t totalTokens = 0;
+    size_t totalBytes = 0;
+    size_t unreadable = 0;
+    const size_t errorIndex = static_cast<size_t>(TokenType::UNRECOGNIZED);
+
+    for (const auto& result : results) {
+        out.write(result.path);
+        if (!result.opened) {
+            out.write(": cannot open\n");
+            unreadable++;
+            continue;
+        }
+
+        out.write(": ");
+        out.writeNumber(result.tokens);
+        out.write(" tokens, ");
+        out.writeNumber(result.byType[errorIndex]);
+        out.write(" errors, ");
+        out.writeNumber(result.bytes);
+        out.write(" bytes\n");
+
+        for (size_t t = 0; t < TYPE_COUNT; t++) {
+            totalTypes[t] += result.byType[t];
+        }
+        totalTokens += result.tokens;
+        totalBytes += result.bytes;
+    }
+
+    out.write("\nFiles: ");
+    out.writeNumber(results.size());
+    if (unreadable > 0) {
+        out.write(" (");
+        out.writeNumber(unreadable);
+        out.write(" unreadable)");
+    }
+    out.write("\nTokens: ");
+    out.writeNumber(totalTokens);
+    out.put('\n');
+    for (size_t t = 0; t < TYPE_COUNT; t++) {
+        out.write("  ");
+        out.write(tokenTypeName(static_cast<TokenType>(t)));
+        out.write(": ");
+        out.writeNumber(totalTypes[t]);
+        out.put('\n');
+    }
+    out.write("Errors: ");
+    out.writeNumber(totalTypes[errorIndex]);
+    out.write("\nBytes: ");
+    out.writeNumber(totalBytes);
+    out.write("\nTime: ");
+    writeRate(out, seconds * 1000);
+    out.write(" ms (");
+    writeRate(out, seconds > 0 ? totalBytes / seconds / (1 << 20) : 0);
+    out.write(" MB/s)\n");
+}
+
+} // namespace batch
@@ -0,0 +1,38 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "lexer.h"
+
+class OutputWriter;
+
+// Batch mode: lexes many files in one process on a thread pool
+namespace batch {
+
+const size_t TYPE_COUNT = static_cast<size_t>(TokenType::END_OF_FILE);
+
+struct FileResult {
+    std::string path;
+    bool opened;
+    size_t bytes;
+    size_t tokens;              // Not counting END_OF_FILE
+    size_t byType[TYPE_COUNT];
+};
+
+// Expands the inputs in order: files are kept as given, directories are
+// searched recursively for .vb files, and anything else is tried as a glob.
+// Matches from one input are sorted so the list does not depend on the
+// order the file system returns entries in.
+std::vector<std::string> collectSources(const std::vector<std::string>& inputs);
+
+// Lexes every file; results come back in the order of 'files'
+std::vector<FileResult> lexFiles(const std::vector<std::string>& files, size_t threadCount);
+
+// One line per file followed by totals per token type
+void printReport(const std::vector<FileResult>& results, double seconds, OutputWriter& out);
+
+} // namespace batch
+
+#endif // BATCH_H
@@ -0,0 +1,491 @@
+#include "incremental_lexer.h"
+#include "keywords.h"
+#include "lexer.h"
+#include "output_writer.h"
+#include "token_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Every heap allocation in the process goes through here so phases can
+// report allocations per token
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+// Reference implementation: the original linear scan over the reserved word
+// list, upper-casing the candidate and every reserved word on each call.
+static bool linearIsReservedWord(const std::string& word) {
+    std::string upperWord = word;
+    std::transform(upperWord.begin(), upperWord.end(), upperWord.begin(), ::toupper);
+
+    for (const auto& reserved : keywords::RESERVED_WORDS) {
+        std::string upperReserved(reserved);
+        std::transform(upperReserved.begin(), upperReserved.end(), upperReserved.begin(), ::toupper);
+        if (upperWord == upperReserved) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Mix of reserved words in random case and plain identifiers
+static std::vector<std::string> makeCandidates(size_t count) {
+    std::mt19937 rng(42);
+    std::vector<std::string> candidates;
+    candidates.reserve(count);
+
+    const char* letters = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+    for (size_t i = 0; i < count; i++) {
+        std::string word;
+        if (rng() % 2 == 0) {
+            word = std::string(keywords::RESERVED_WORDS[rng() % keywords::WORD_COUNT]);
+            for (char& c : word) {
+                if (rng() % 2 == 0) {
+                    c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+                }
+            }
+        } else {
+            size_t length = 1 + rng() % 12;
+            for (size_t j = 0; j < length; j++) {
+                word += letters[rng() % 53];
+            }
+        }
+        candidates.push_back(word);
+    }
+    return candidates;
+}
+
+// Keeps the compiler from hoisting lookups out of the timing loop
+static volatile size_t sink;
+
+template <typename Classifier>
+static double timeLookups(const std::vector<std::string>& candidates, int rounds,
+                          Classifier classify) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& word : candidates) {
+            sink = sink + (classify(word) ? 1 : 0);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (static_cast<double>(candidates.size()) * rounds);
+}
+
+static int benchKeywords() {
+    std::vector<std::string> candidates = makeCandidates(100000);
+
+    // Both implementations must classify every candidate the same way
+    for (const auto& word : candidates) {
+        if (linearIsReservedWord(word) != keywords::isReservedWord(word)) {
+            std::cerr << "Mismatch on '" << word << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    double linearNs = timeLookups(candidates, 1, linearIsReservedWord);
+    double hashNs = timeLookups(candidates, 50,
+        [](const std::string& w) { return keywords::isReservedWord(w); });
+
+    std::cout << "isReservedWord (" << candidates.size() << " candidates)" << std::endl;
+    std::cout << "  linear scan  : " << linearNs << " ns/lookup" << std::endl;
+    std::cout << "  perfect hash : " << hashNs << " ns/lookup" << std::endl;
+    std::cout << "  speedup      : " << linearNs / hashNs << "x" << std::endl;
+    return 0;
+}
+
+// Counts tokens of every kind, the simplest downstream pass
+template <typename Tokens, typename TypeOf>
+static double timeKindCount(const Tokens& tokens, size_t count, int rounds, TypeOf typeOf) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        size_t histogram[static_cast<size_t>(TokenType::END_OF_FILE) + 1] = {};
+        for (size_t i = 0; i < count; i++) {
+            histogram[static_cast<size_t>(typeOf(tokens, i))]++;
+        }
+        sink = sink + histogram[static_cast<size_t>(TokenType::IDENTIFIER)];
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(count) * rounds);
+}
+
+static int benchTokenStorage(const std::string& filename, const std::string& label) {
+    Lexer lexer(filename);
+    std::vector<Token> tokens = lexer.tokenize();
+    TokenBuffer compact = lexer.tokenizeCompact();
+
+    // The compact form must describe exactly the same tokens
+    if (compact.size() != tokens.size()) {
+        std::cerr << "Token count mismatch: " << compact.size() << " vs " << tokens.size() << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < tokens.size(); i++) {
+        Token token = compact.at(i);
+        SourceLocation at = lexer.locate(tokens[i].position);
+        if (token.type != tokens[i].type || token.value != tokens[i].value || token.position != tokens[i].position ||
+            compact.line(i) != at.line || compact.column(i) != at.column) {
+            std::cerr << "Token " << i << " differs in compact storage" << std::endl;
+            return 1;
+        }
+    }
+
+    size_t count = tokens.size();
+    size_t vectorBytes = tokens.capacity() * sizeof(Token);
+    size_t compactBytes = compact.memoryUsage();
+    int rounds = static_cast<int>(std::max<size_t>(1, 20000000 / count));
+
+    double vectorNs = timeKindCount(tokens, count, rounds,
+        [](const std::vector<Token>& t, size_t i) { return t[i].type; });
+    double compactNs = timeKindCount(compact, count, rounds,
+        [](const TokenBuffer& t, size_t i) { return t.type(i); });
+
+    std::cout << "Token storage (" << label << ", " << count << " tokens)" << std::endl;
+    std::cout << "  std::vector<Token> : " << vectorBytes << " bytes, "
+              << static_cast<double>(vectorBytes) / count << " bytes/token, "
+              << vectorNs << " ns/token to count kinds" << std::endl;
+    std::cout << "  TokenBuffer        : " << compactBytes << " bytes, "
+              << static_cast<double>(compactBytes) / count << " bytes/token, "
+              << compactNs << " ns/token to count kinds" << std::endl;
+    std::cout << "  reduction          : " << static_cast<double>(vectorBytes) / compactBytes << "x" << std::endl;
+    return 0;
+}
+
+// Synthetic VB source with a chosen balance of token kinds
+enum class Mix { IDENTIFIERS, COMMENTS, NUMBERS, STRINGS, MIXED };
+
+static const struct {
+    Mix mix;
+    const char* name;
+} MIXES[] = {
+    {Mix::IDENTIFIERS, "identifiers"},
+    {Mix::COMMENTS, "comments"},
+    {Mix::NUMBERS, "numbers"},
+    {Mix::STRINGS, "strings"},
+    {Mix::MIXED, "mixed"},
+};
+
+static std::string randomIdentifier(std::mt19937& rng) {
+    static const char* parts[] = {"value", "Count", "index", "Total", "name", "Buffer", "item",
+                                  "Result", "temp", "Offset", "row", "Column", "key", "Data"};
+    std::string word = parts[rng() % 14];
+    size_t extra = rng() % 3;
+    for (size_t i = 0; i < extra; i++) {
+        word += parts[rng() % 14];
+    }
+    if (rng() % 4 == 0) {
+        word += std::to_string(rng() % 100);
+    }
+    return word;
+}
+
+static std::string randomNumber(std::mt19937& rng) {
+    switch (rng() % 4) {
+        case 0:
+            return std::to_string(rng() % 100000);
+        case 1:
+            return std::to_string(rng() % 1000) + "." + std::to_string(rng() % 100000);
+        case 2:
+            return std::to_string(rng() % 10) + "." + std::to_string(rng() % 1000) + "E+" + std::to_string(rng() % 30);
+        default: {
+            char hex[16];
+            std::snprintf(hex, sizeof(hex), "&H%X", static_cast<unsigned>(rng() % 0x100000));
+            return hex;
+        }
+    }
+}
+
+static void appendLine(Mix mix, std::mt19937& rng, std::string& out) {
+    static const char* words = "the quick brown fox jumps over the lazy dog while parsing some text ";
+    out += "        ";
+
+    switch (mix) {
+        case Mix::IDENTIFIERS:
+            out += "Dim " + randomIdentifier(rng) + " As " + randomIdentifier(rng) + " = " +
+                   randomIdentifier(rng) + "." + randomIdentifier(rng) + "(" + randomIdentifier(rng) +
+                   ", " + randomIdentifier(rng) + ")";
+            break;
+        case Mix::COMMENTS:
+            out += rng() % 3 == 0 ? "REM " : "' ";
+            for (size_t i = 0, n = 1 + rng() % 3; i < n; i++) {
+                out += words;
+            }
+            break;
+        case Mix::NUMBERS:
+            out += randomIdentifier(rng) + " = " + randomNumber(rng);
+            for (size_t i = 0, n = 2 + rng() % 4; i < n; i++) {
+                out += " + " + randomNumber(rng);
+            }
+            break;
+        case Mix::STRINGS:
+            out += randomIdentifier(rng) + " = \"";
+            for (size_t i = 0, n = 1 + rng() % 4; i < n; i++) {
+                out += words;
+                if (rng() % 3 == 0) {
+                    out += "\\\"quoted\\\" ";
+                }
+            }
+            out += "\" & \"x\"c";
+            break;
+        case Mix::MIXED:
+            appendLine(static_cast<Mix>(rng() % 4), rng, out);
+            return;
+    }
+    out += "\n";
+}
+
+static std::string generateCorpus(Mix mix, size_t bytes) {
+    std::mt19937 rng(1234);
+    std::string out;
+    out.reserve(bytes + 256);
+
+    out += "Module Generated\n    Sub Main()\n";
+    while (out.size() < bytes) {
+        appendLine(mix, rng, out);
+    }
+    out += "    End Sub\nEnd Module\n";
+    return out;
+}
+
+// Writes the corpus to a temporary file, since the Lexer reads from files
+static std::string writeTempFile(const std::string& text) {
+    char path[] = "/tmp/lexer_bench_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return std::string();
+    }
+    size_t done = 0;
+    while (done < text.size()) {
+        ssize_t n = write(fd, text.data() + done, text.size() - done);
+        if (n <= 0) {
+            close(fd);
+            unlink(path);
+            return std::string();
+        }
+        done += static_cast<size_t>(n);
+    }
+    close(fd);
+    return path;
+}
+
+struct PhaseResult {
+    double seconds;
+    size_t allocations;
+};
+
+// Best of a few runs; allocations are counted on the last one
+template <typename Phase>
+static PhaseResult timePhase(int runs, Phase phase) {
+    PhaseResult best{1e300, 0};
+    for (int r = 0; r < runs; r++) {
+        size_t before = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        phase();
+        auto end = std::chrono::steady_clock::now();
+        best.seconds = std::min(best.seconds, std::chrono::duration<double>(end - start).count());
+        best.allocations = allocationCount.load(std::memory_order_relaxed) - before;
+    }
+    return best;
+}
+
+static void reportPhase(const char* name, const PhaseResult& result, size_t bytes, size_t tokens) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-16s %9.1f MB/s %9.2f Mtokens/s %8.3f allocs/token",
+                  name, bytes / result.seconds / (1 << 20), tokens / result.seconds / 1e6,
+                  static_cast<double>(result.allocations) / tokens);
+    std::cout << line << std::endl;
+}
+
+static int benchLexer(const std::string& filename, const std::string& label) {
+    const int runs = 3;
+    size_t bytes = 0;
+    size_t tokenCount = 0;
+
+    // Each phase gets a fresh Lexer so it starts from an unread source
+    PhaseResult tokenizeResult = timePhase(runs, [&] {
+        Lexer lexer(filename);
+        std::vector<Token> tokens = lexer.tokenize();
+        tokenCount = tokens.size();
+        bytes = tokens.back().position;
+    });
+    if (tokenCount == 0) {
+        return 1;
+    }
+
+    PhaseResult compactResult = timePhase(runs, [&] {
+        Lexer lexer(filename);
+        TokenBuffer tokens = lexer.tokenizeCompact();
+    });
+
+    auto printPhase = [&](bool colored) {
+        Lexer lexer(filename);
+        std::vector<Token> tokens = lexer.tokenize();
+        OutputWriter out;
+        out.open("/dev/null");
+        return timePhase(runs, [&] {
+            if (colored) {
+                lexer.printColored(tokens, out);
+            } else {
+                lexer.printTokens(tokens, out);
+            }
+            out.flush();
+        });
+    };
+    PhaseResult pairsResult = printPhase(false);
+    PhaseResult coloredResult = printPhase(true);
+
+    std::cout << "Lexer on " << label << " (" << bytes << " bytes, " << tokenCount << " tokens)" << std::endl;
+    reportPhase("tokenize", tokenizeResult, bytes, tokenCount);
+    reportPhase("tokenizeCompact", compactResult, bytes, tokenCount);
+    reportPhase("printTokens", pairsResult, bytes, tokenCount);
+    reportPhase("printColored", coloredResult, bytes, tokenCount);
+    return 0;
+}
+
+// Average time of one IncrementalLexer edit, each undone by the next so
+// the text stays the same size. 'near' keeps every edit within a line of
+// the last, like typing; otherwise each edit lands at a random offset.
+static double timeEdits(IncrementalLexer& lexer, size_t length, bool near, std::mt19937& rng) {
+    const int edits = 2000;
+    size_t at = length / 2;
+    // The first edit pays once for moving the gaps from the end of the file
+    lexer.applyEdit(TextEdit{at, 0, "x"});
+    lexer.applyEdit(TextEdit{at, 1, ""});
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < edits; i += 2) {
+        at = near ? std::min(length - 1, at + rng() % 64) : rng() % length;
+        lexer.applyEdit(TextEdit{at, 0, "x"});
+        lexer.applyEdit(TextEdit{at, 1, ""});
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / edits;
+}
+
+// Edit latency against file size: an edit should cost about the same on
+// every size, while a full tokenize grows with the file
+static int benchIncremental() {
+    std::cout << "IncrementalLexer edits (mixed corpus)" << std::endl;
+    for (size_t bytes : {size_t(64) << 10, size_t(512) << 10, size_t(4) << 20, size_t(12) << 20, size_t(32) << 20}) {
+        std::string text = generateCorpus(Mix::MIXED, bytes);
+        size_t lines = std::count(text.begin(), text.end(), '\n');
+        std::string path = writeTempFile(text);
+        if (path.empty()) {
+            std::cerr << "Error: Cannot write the generated corpus" << std::endl;
+            return 1;
+        }
+        PhaseResult full = timePhase(3, [&] {
+            Lexer lexer(path);
+            lexer.tokenize();
+        });
+        unlink(path.c_str());
+
+        std::mt19937 rng(42);
+        IncrementalLexer lexer(text);
+        double nearUs = timeEdits(lexer, text.size(), true, rng);
+        double randomUs = timeEdits(lexer, text.size(), false, rng);
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %8zu lines  tokenize %9.2f ms  nearby edit %8.2f us  random edit %8.2f us",
+                      lines, full.seconds * 1e3, nearUs, randomUs);
+        std::cout << line << std::endl;
+    }
+    return 0;
+}
+
+static void usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--size <MB>] [--mix <name>] [file]" << std::endl;
+    std::cerr << "       " << program << " --incremental" << std::endl;
+    std::cerr << "  --size  : Size of each generated corpus (default 8 MB)" << std::endl;
+    std::cerr << "  --mix   : identifiers, comments, numbers, strings or mixed (default: all)" << std::endl;
+    std::cerr << "  file    : Benchmark this file instead of a generated corpus" << std::endl;
+    std::cerr << "  --incremental : Time IncrementalLexer edits on growing files" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    size_t corpusBytes = 8 << 20;
+    std::string mixName;
+    std::string input;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            corpusBytes = static_cast<size_t>(std::strtod(argv[++i], nullptr) * (1 << 20));
+        } else if (arg == "--mix" && i + 1 < argc) {
+            mixName = argv[++i];
+        } else if (arg == "--incremental") {
+            return benchIncremental();
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            input = arg;
+        }
+    }
+
+    if (benchKeywords() != 0) {
+        return 1;
+    }
+
+    if (!input.empty()) {
+        std::cout << std::endl;
+        if (benchLexer(input, input) != 0 || benchTokenStorage(input, input) != 0) {
+            return 1;
+        }
+        return 0;
+    }
+
+    bool found = false;
+    for (const auto& entry : MIXES) {
+        if (!mixName.empty() && mixName != entry.name) {
+            continue;
+        }
+        found = true;
+
+        std::string path = writeTempFile(generateCorpus(entry.mix, corpusBytes));
+        if (path.empty()) {
+            std::cerr << "Error: Cannot write the generated corpus" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::endl;
+        int status = benchLexer(path, std::string(entry.name) + " corpus");
+        if (status == 0 && entry.mix == Mix::MIXED) {
+            status = benchTokenStorage(path, std::string(entry.name) + " corpus");
+        }
+        unlink(path.c_str());
+        if (status != 0) {
+            return 1;
+        }
+    }
+
+    if (!found) {
+        usage(argv[0]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,299 @@
+#ifndef DFA_H
+#define DFA_H
+
+#include "lexer.h"
+#include <array>
+#include <cstdint>
+
+// Tables driving Lexer::scanToken.
+// Every input byte is first mapped to a character class, and the scanner then
+// follows a state-transition table indexed by [state][class]. Each state says
+// which token it accepts, so a token is the longest prefix that ends in an
+// accepting state (maximal munch). All tables are built at compile time.
+namespace dfa {
+
+enum CharClass : uint8_t {
+    C_NUL,          // '\0' stops the scan
+    C_OTHER,        // Anything without a meaning of its own
+    C_BLANK,        // ' ', '\t', '\r'
+    C_NEWLINE,
+    C_DIGIT,
+    C_HEX_ALPHA,    // Hex letters that are not special elsewhere: a b d f
+    C_LETTER_C,     // Character constant suffix, hex digit
+    C_LETTER_E,     // Exponent marker, hex digit
+    C_LETTER_H,     // Hex prefix after '&'
+    C_LETTER,       // Remaining letters and '_'
+    C_QUOTE,
+    C_APOSTROPHE,
+    C_HASH,
+    C_AMPERSAND,
+    C_BANG,
+    C_AT,
+    C_PERCENT,
+    C_PLUS,
+    C_MINUS,
+    C_LESS,
+    C_GREATER,
+    C_EQUALS,
+    C_SLASH,
+    C_BACKSLASH,
+    C_OPERATOR,     // '*', '^'
+    C_DOT,
+    C_DELIMITER,    // ( ) [ ] { } , ; :
+    CLASS_COUNT
+};
+
+enum State : uint8_t {
+    S_DEAD,         // No transition; must stay zero so empty table cells mean "stop"
+    S_START,
+    S_BLANK,
+    S_NEWLINE,
+    S_IDENTIFIER,
+    S_INTEGER,
+    S_INTEGER_DOT,  // Seen "123." and waiting for a fraction digit
+    S_INTEGER_SUFFIX,
+    S_FRACTION,
+    S_EXPONENT,
+    S_EXPONENT_SIGN,
+    S_EXPONENT_DIGITS,
+    S_FLOAT_SUFFIX,
+    S_AMPERSAND,
+    S_HEX,
+    S_HEX_SUFFIX,
+    S_STRING,
+    S_STRING_ESCAPE,
+    S_STRING_CLOSED,
+    S_CHARACTER,
+    S_COMMENT,
+    S_PREPROCESSOR,
+    S_LESS,
+    S_GREATER,
+    S_SLASH,
+    S_OPERATOR,
+    S_DELIMITER,
+    S_UNRECOGNIZED,
+    STATE_COUNT
+};
+
+// Accept codes: a TokenType, or one of the two markers below
+constexpr uint8_t ACCEPT_NONE = 0xFF;
+constexpr uint8_t ACCEPT_SKIP = 0xFE;
+
+// States that loop on themselves over long runs of input; the scanner jumps
+// over such runs with the vectorized searches in simd_scan.h
+enum Run : uint8_t {
+    RUN_NONE,
+    RUN_BLANKS,     // Blanks between tokens
+    RUN_LINE,       // Comment or directive text up to the end of the line
+    RUN_STRING      // String body up to a quote, backslash or newline
+};
+
+using ClassTable = std::array<uint8_t, 256>;
+using TransitionTable = std::array<std::array<uint8_t, CLASS_COUNT>, STATE_COUNT>;
+using AcceptTable = std::array<uint8_t, STATE_COUNT>;
+using RunTable = std::array<uint8_t, STATE_COUNT>;
+
+constexpr ClassTable buildClassTable() {
+    ClassTable table{};
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = C_OTHER;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+        table[c] = C_LETTER;
+        table[c - 'a' + 'A'] = C_LETTER;
+    }
+    for (int c = '0'; c <= '9'; c++) {
+        table[c] = C_DIGIT;
+    }
+    for (char c : {'a', 'b', 'd', 'f', 'A', 'B', 'D', 'F'}) {
+        table[static_cast<unsigned char>(c)] = C_HEX_ALPHA;
+    }
+    table['c'] = table['C'] = C_LETTER_C;
+    table['e'] = table['E'] = C_LETTER_E;
+    table['h'] = table['H'] = C_LETTER_H;
+    table['_'] = C_LETTER;
+
+    table['\0'] = C_NUL;
+    table[' '] = table['\t'] = table['\r'] = C_BLANK;
+    table['\n'] = C_NEWLINE;
+    table['"'] = C_QUOTE;
+    table['\''] = C_APOSTROPHE;
+    table['#'] = C_HASH;
+    table['&'] = C_AMPERSAND;
+    table['!'] = C_BANG;
+    table['@'] = C_AT;
+    table['%'] = C_PERCENT;
+    table['+'] = C_PLUS;
+    table['-'] = C_MINUS;
+    table['<'] = C_LESS;
+    table['>'] = C_GREATER;
+    table['='] = C_EQUALS;
+    table['/'] = C_SLASH;
+    table['\\'] = C_BACKSLASH;
+    table['*'] = table['^'] = C_OPERATOR;
+    table['.'] = C_DOT;
+    for (char c : {'(', ')', '[', ']', '{', '}', ',', ';', ':'}) {
+        table[static_cast<unsigned char>(c)] = C_DELIMITER;
+    }
+    return table;
+}
+
+constexpr bool isLetterClass(size_t c) {
+    return c == C_HEX_ALPHA || c == C_LETTER_C || c == C_LETTER_E ||
+           c == C_LETTER_H || c == C_LETTER;
+}
+
+constexpr bool isHexDigitClass(size_t c) {
+    return c == C_DIGIT || c == C_HEX_ALPHA || c == C_LETTER_C || c == C_LETTER_E;
+}
+
+constexpr TransitionTable buildTransitionTable() {
+    TransitionTable t{};
+
+    for (size_t c = 0; c < CLASS_COUNT; c++) {
+        // Identifiers: letter or '_' followed by letters, digits and '_'
+        if (isLetterClass(c)) {
+            t[S_START][c] = S_IDENTIFIER;
+        }
+        if (isLetterClass(c) || c == C_DIGIT) {
+            t[S_IDENTIFIER][c] = S_IDENTIFIER;
+        }
+
+        // Hexadecimal: &H followed by hex digits
+        if (isHexDigitClass(c)) {
+            t[S_HEX][c] = S_HEX;
+        }
+
+        // String bodies run to the closing quote, the end of the line or '\0';
+        // a backslash always takes the next character with it
+        if (c != C_QUOTE && c != C_NEWLINE && c != C_NUL && c != C_BACKSLASH) {
+            t[S_STRING][c] = S_STRING;
+        }
+        t[S_STRING_ESCAPE][c] = S_STRING;
+
+        // Comments and directives run to the end of the line
+        if (c != C_NEWLINE && c != C_NUL) {
+            t[S_COMMENT][c] = S_COMMENT;
+            t[S_PREPROCESSOR][c] = S_PREPROCESSOR;
+        }
+    }
+
+    t[S_START][C_BLANK] = S_BLANK;
+    t[S_BLANK][C_BLANK] = S_BLANK;
+    t[S_START][C_NEWLINE] = S_NEWLINE;
+
+    // Decimal integers, with an optional type suffix
+    t[S_START][C_DIGIT] = S_INTEGER;
+    t[S_INTEGER][C_DIGIT] = S_INTEGER;
+    t[S_INTEGER][C_DOT] = S_INTEGER_DOT;
+    for (uint8_t c : {C_AMPERSAND, C_BANG, C_HASH, C_AT, C_PERCENT}) {
+        t[S_INTEGER][c] = S_INTEGER_SUFFIX;
+    }
+
+    // Floating point: digits '.' digits [E [+|-] digits] [suffix]
+    t[S_INTEGER_DOT][C_DIGIT] = S_FRACTION;
+    t[S_FRACTION][C_DIGIT] = S_FRACTION;
+    t[S_FRACTION][C_LETTER_E] = S_EXPONENT;
+    t[S_EXPONENT][C_PLUS] = S_EXPONENT_SIGN;
+    t[S_EXPONENT][C_MINUS] = S_EXPONENT_SIGN;
+    t[S_EXPONENT][C_DIGIT] = S_EXPONENT_DIGITS;
+    t[S_EXPONENT_SIGN][C_DIGIT] = S_EXPONENT_DIGITS;
+    t[S_EXPONENT_DIGITS][C_DIGIT] = S_EXPONENT_DIGITS;
+    for (uint8_t s : {S_FRACTION, S_EXPONENT, S_EXPONENT_SIGN, S_EXPONENT_DIGITS}) {
+        for (uint8_t c : {C_BANG, C_HASH, C_AT}) {
+            t[s][c] = S_FLOAT_SUFFIX;
+        }
+    }
+
+    // '&' is concatenation unless it starts a hex literal
+    t[S_START][C_AMPERSAND] = S_AMPERSAND;
+    t[S_AMPERSAND][C_LETTER_H] = S_HEX;
+    for (uint8_t c : {C_AMPERSAND, C_BANG, C_HASH}) {
+        t[S_HEX][c] = S_HEX_SUFFIX;
+    }
+
+    t[S_START][C_QUOTE] = S_STRING;
+    t[S_STRING][C_QUOTE] = S_STRING_CLOSED;
+    t[S_STRING][C_BACKSLASH] = S_STRING_ESCAPE;
+    t[S_STRING_CLOSED][C_LETTER_C] = S_CHARACTER;
+
+    t[S_START][C_APOSTROPHE] = S_COMMENT;
+    t[S_START][C_HASH] = S_PREPROCESSOR;
+
+    // Operators: < <= <> > >= / /= and single-character ones
+    t[S_START][C_LESS] = S_LESS;
+    t[S_LESS][C_EQUALS] = S_OPERATOR;
+    t[S_LESS][C_GREATER] = S_OPERATOR;
+    t[S_START][C_GREATER] = S_GREATER;
+    t[S_GREATER][C_EQUALS] = S_OPERATOR;
+    t[S_START][C_SLASH] = S_SLASH;
+    t[S_SLASH][C_EQUALS] = S_OPERATOR;
+    for (uint8_t c : {C_EQUALS, C_PLUS, C_MINUS, C_BACKSLASH, C_OPERATOR}) {
+        t[S_START][c] = S_OPERATOR;
+    }
+
+    t[S_START][C_DOT] = S_DELIMITER;
+    t[S_START][C_DELIMITER] = S_DELIMITER;
+
+    for (uint8_t c : {C_OTHER, C_BANG, C_AT, C_PERCENT}) {
+        t[S_START][c] = S_UNRECOGNIZED;
+    }
+
+    return t;
+}
+
+constexpr uint8_t accepts(TokenType type) {
+    return static_cast<uint8_t>(type);
+}
+
+constexpr AcceptTable buildAcceptTable() {
+    AcceptTable a{};
+    for (size_t s = 0; s < STATE_COUNT; s++) {
+        a[s] = ACCEPT_NONE;
+    }
+
+    a[S_BLANK] = ACCEPT_SKIP;
+    a[S_NEWLINE] = ACCEPT_SKIP;
+    a[S_IDENTIFIER] = accepts(TokenType::IDENTIFIER);
+    a[S_INTEGER] = accepts(TokenType::DECIMAL_INTEGER);
+    a[S_INTEGER_SUFFIX] = accepts(TokenType::DECIMAL_INTEGER);
+    a[S_FRACTION] = accepts(TokenType::FLOATING_POINT);
+    a[S_EXPONENT] = accepts(TokenType::FLOATING_POINT);
+    a[S_EXPONENT_SIGN] = accepts(TokenType::FLOATING_POINT);
+    a[S_EXPONENT_DIGITS] = accepts(TokenType::FLOATING_POINT);
+    a[S_FLOAT_SUFFIX] = accepts(TokenType::FLOATING_POINT);
+    a[S_AMPERSAND] = accepts(TokenType::OPERATOR);
+    a[S_HEX] = accepts(TokenType::HEXADECIMAL);
+    a[S_HEX_SUFFIX] = accepts(TokenType::HEXADECIMAL);
+    a[S_STRING] = accepts(TokenType::STRING_CONSTANT);
+    a[S_STRING_ESCAPE] = accepts(TokenType::STRING_CONSTANT);
+    a[S_STRING_CLOSED] = accepts(TokenType::STRING_CONSTANT);
+    a[S_CHARACTER] = accepts(TokenType::CHARACTER_CONSTANT);
+    a[S_COMMENT] = accepts(TokenType::COMMENT);
+    a[S_PREPROCESSOR] = accepts(TokenType::PREPROCESSOR_DIRECTIVE);
+    a[S_LESS] = accepts(TokenType::OPERATOR);
+    a[S_GREATER] = accepts(TokenType::OPERATOR);
+    a[S_SLASH] = accepts(TokenType::OPERATOR);
+    a[S_OPERATOR] = accepts(TokenType::OPERATOR);
+    a[S_DELIMITER] = accepts(TokenType::DELIMITER);
+    a[S_UNRECOGNIZED] = accepts(TokenType::UNRECOGNIZED);
+    return a;
+}
+
+constexpr RunTable buildRunTable() {
+    RunTable r{};
+    r[S_BLANK] = RUN_BLANKS;
+    r[S_COMMENT] = RUN_LINE;
+    r[S_PREPROCESSOR] = RUN_LINE;
+    r[S_STRING] = RUN_STRING;
+    return r;
+}
+
+constexpr ClassTable CHAR_CLASS = buildClassTable();
+constexpr TransitionTable TRANSITIONS = buildTransitionTable();
+constexpr AcceptTable ACCEPT = buildAcceptTable();
+constexpr RunTable RUNS = buildRunTable();
+
+} // namespace dfa
+
+#endif // DFA_H
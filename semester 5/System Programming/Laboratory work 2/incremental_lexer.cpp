@@ -0,0 +1,229 @@
+#include "incremental_lexer.h"
+#include <algorithm>
+#include <cstring>
+
+// Both gaps start at the end with some room, so the first edits that grow
+// the text or the token count do not have to reallocate
+IncrementalLexer::IncrementalLexer(std::string_view source)
+    : buffer(source.size() + source.size() / 8 + 64), gapStart(source.size()), gapEnd(buffer.size()) {
+    std::copy(source.begin(), source.end(), buffer.begin());
+    std::vector<Token> tokens;
+    size_t end = Lexer::scanRange(buffer.data(), 0, source.size(), tokens);
+
+    entries.reserve(tokens.size() + tokens.size() / 8 + 16);
+    for (const Token& token : tokens) {
+        entries.push_back(Entry{token.type, token.position, token.value.size()});
+    }
+    entries.push_back(Entry{TokenType::END_OF_FILE, end, 0});
+    tokenGapStart = entries.size();
+    entries.resize(entries.capacity());
+    tokenGapEnd = entries.size();
+}
+
+void IncrementalLexer::copyText(size_t begin, size_t end, char* out) const {
+    if (begin < gapStart) {
+        size_t front = std::min(end, gapStart) - begin;
+        std::memcpy(out, buffer.data() + begin, front);
+        out += front;
+        begin += front;
+    }
+    if (begin < end) {
+        std::memcpy(out, buffer.data() + begin + gapLength(), end - begin);
+    }
+}
+
+size_t IncrementalLexer::positionAt(size_t index) const {
+    const Entry& entry = entries[entryIndex(index)];
+    return index < tokenGapStart ? entry.position : length() - entry.position;
+}
+
+void IncrementalLexer::moveGap(size_t offset, size_t room) {
+    if (gapLength() < room) {
+        // Grow geometrically so a run of insertions stays amortized O(1) a byte
+        size_t textLength = length();
+        std::vector<char> grown(textLength + std::max(room, textLength / 2 + 64));
+        size_t grownGapEnd = grown.size() - (textLength - offset);
+        copyText(0, offset, grown.data());
+        copyText(offset, textLength, grown.data() + grownGapEnd);
+        buffer.swap(grown);
+        gapStart = offset;
+        gapEnd = grownGapEnd;
+    } else if (offset < gapStart) {
+        size_t count = gapStart - offset;
+        std::memmove(buffer.data() + gapEnd - count, buffer.data() + offset, count);
+        gapStart = offset;
+        gapEnd -= count;
+    } else if (offset > gapStart) {
+        size_t count = offset - gapStart;
+        std::memmove(buffer.data() + gapStart, buffer.data() + gapEnd, count);
+        gapStart = offset;
+        gapEnd += count;
+    }
+}
+
+// Entries crossing the gap switch between an offset and a distance from the
+// end, which are both L - x of each other for the current text length L
+void IncrementalLexer::moveTokenGap(size_t index, size_t room) {
+    size_t textLength = length();
+    if (tokenGapEnd - tokenGapStart < room) {
+        size_t count = tokenCount();
+        std::vector<Entry> grown(count + std::max(room, count / 2 + 16));
+        size_t grownGapEnd = grown.size() - (count - index);
+        for (size_t i = 0; i < count; i++) {
+            Entry entry = entries[entryIndex(i)];
+            size_t position = positionAt(i);
+            entry.position = i < index ? position : textLength - position;
+            grown[i < index ? i : grownGapEnd + (i - index)] = entry;
+        }
+        entries.swap(grown);
+        tokenGapStart = index;
+        tokenGapEnd = grownGapEnd;
+        return;
+    }
+
+    while (tokenGapStart > index) {
+        Entry entry = entries[--tokenGapStart];
+        entry.position = textLength - entry.position;
+        entries[--tokenGapEnd] = entry;
+    }
+    while (tokenGapStart < index) {
+        Entry entry = entries[tokenGapEnd++];
+        entry.position = textLength - entry.position;
+        entries[tokenGapStart++] = entry;
+    }
+}
+
+// Start of the line holding 'offset', extended upwards past lines ended by
+// an escaped newline. No token or lookahead crosses the newline before it,
+// so lexing can restart there with the tokens in front left untouched.
+// The text before 'offset' must all be in front of the gap.
+size_t IncrementalLexer::findRestart(size_t offset) const {
+    std::string_view before(buffer.data(), offset);
+    size_t pos = offset;
+    while (pos > 0) {
+        size_t newline = before.rfind('\n', pos - 1);
+        if (newline == std::string_view::npos) {
+            return 0;
+        }
+        if (newline == 0 || before[newline - 1] != '\\') {
+            return newline + 1;
+        }
+        pos = newline;
+    }
+    return 0;
+}
+
+std::string IncrementalLexer::getText() const {
+    std::string text(length(), '\0');
+    copyText(0, length(), text.data());
+    return text;
+}
+
+Token IncrementalLexer::token(size_t index) const {
+    const Entry& entry = entries[entryIndex(index)];
+    size_t position = positionAt(index);
+    if (entry.type == TokenType::END_OF_FILE) {
+        return Token(entry.type, std::string_view(), position);
+    }
+    // The text gap always sits between tokens, so a token is on one side
+    const char* data = buffer.data() + (position < gapStart ? position : position + gapLength());
+    return Token(entry.type, std::string_view(data, entry.length), position);
+}
+
+std::vector<Token> IncrementalLexer::getTokens() const {
+    std::vector<Token> tokens;
+    tokens.reserve(tokenCount());
+    for (size_t i = 0; i < tokenCount(); i++) {
+        tokens.push_back(token(i));
+    }
+    return tokens;
+}
+
+TokenDelta IncrementalLexer::applyEdit(const TextEdit& edit) {
+    size_t offset = std::min(edit.offset, length());
+    size_t removed = std::min(edit.removedLength, length() - offset);
+    size_t inserted = edit.insertedText.size();
+
+    // Lexing stops at a '\0', so an edit past it only re-checks the end
+    moveGap(offset, inserted);
+    size_t restart = std::min(findRestart(offset), positionAt(tokenCount() - 1));
+
+    // The first token at or after the restart point; END_OF_FILE always is
+    size_t low = 0;
+    size_t high = tokenCount() - 1;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (positionAt(mid) < restart) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    size_t firstIndex = low;
+    moveTokenGap(firstIndex, 0);
+
+    // Tokens after the token gap keep their distance from the end, so from
+    // here on they already hold their positions in the edited text
+    gapEnd += removed;
+    if (inserted > 0) {
+        std::memcpy(buffer.data() + gapStart, edit.insertedText.data(), inserted);
+    }
+    gapStart += inserted;
+    lines.truncate(offset);
+
+    // Put the re-lexed span behind the gap so the scanner sees it whole:
+    // data[i] is the byte at offset i for every i from the restart point on
+    moveGap(restart, 0);
+    const char* data = buffer.data() + gapLength();
+    size_t textLength = length();
+    size_t tailLength = textLength - (offset + inserted);
+
+    // Re-lex until a new token starts where an old token from after the
+    // edit now starts; from there on the two streams are the same
+    TokenDelta delta{firstIndex, 0, {}, 0};
+    size_t resync = tokenGapEnd;
+    size_t pos = restart;
+    for (;;) {
+        size_t tokenStart;
+        TokenType type;
+        size_t tokenEnd = Lexer::scanToken(data, textLength, pos, tokenStart, type);
+
+        // An old token lies after the edit when no more than the unchanged
+        // tail follows it
+        while (resync < entries.size() &&
+               (entries[resync].position > tailLength || textLength - entries[resync].position < tokenStart)) {
+            resync++;
+        }
+        if (resync < entries.size() && textLength - entries[resync].position == tokenStart) {
+            break;
+        }
+
+        if (type == TokenType::END_OF_FILE) {
+            // A new '\0' (or the end of the text) drops every old token left
+            delta.inserted.push_back(Token(type, std::string_view(), tokenStart));
+            resync = entries.size();
+            break;
+        }
+        delta.inserted.push_back(Token(type, std::string_view(data + tokenStart, tokenEnd - tokenStart), tokenStart));
+        pos = tokenEnd;
+    }
+    delta.removedCount = resync - tokenGapEnd;
+    tokenGapEnd = resync;
+    if (resync < entries.size()) {
+        delta.positionShift = static_cast<std::ptrdiff_t>(inserted) - static_cast<std::ptrdiff_t>(removed);
+    }
+
+    moveTokenGap(tokenGapStart, delta.inserted.size());
+    for (const Token& token : delta.inserted) {
+        entries[tokenGapStart++] = Entry{token.type, token.position, token.value.size()};
+    }
+    return delta;
+}
+
+SourceLocation IncrementalLexer::locate(size_t position) {
+    lines.extend(buffer.data(), 0, std::min(position, gapStart));
+    if (position > gapStart) {
+        lines.extend(buffer.data() + gapLength(), 0, position);
+    }
+    return lines.locate(position);
+}
@@ -0,0 +1,95 @@
+#ifndef INCREMENTAL_LEXER_H
+#define INCREMENTAL_LEXER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+#include "line_index.h"
+
+// Replaces removedLength bytes at offset with insertedText
+struct TextEdit {
+    size_t offset;
+    size_t removedLength;
+    std::string_view insertedText;
+};
+
+// Change to the token stream caused by one edit: tokens
+// [firstIndex, firstIndex + removedCount) were replaced by 'inserted', and
+// every later token moved by positionShift bytes. The inserted tokens view
+// the lexer's text and are valid until the next edit.
+struct TokenDelta {
+    size_t firstIndex;
+    size_t removedCount;
+    std::vector<Token> inserted;
+    std::ptrdiff_t positionShift;
+};
+
+// Owns an editable copy of the source and keeps its tokens up to date.
+// An edit re-lexes from the start of its line until the new tokens line up
+// with the old ones again, so the scanning work follows the size of the
+// edit rather than the size of the file.
+//
+// Text and tokens are both kept in gap buffers. The text gap is left at
+// the start of the last re-lexed line and the token gap at the last
+// replaced token, and tokens after the token gap store their distance from
+// the end of the text instead of their offset. An edit therefore moves and
+// rewrites only what lies between it and the previous edit, plus the span
+// it re-lexes; the tokens after it keep their stored values.
+class IncrementalLexer {
+private:
+    // A token without its text. 'position' is the offset for entries before
+    // the token gap and the distance from the end of the text after it.
+    struct Entry {
+        TokenType type;
+        size_t position;
+        size_t length;
+    };
+
+    std::vector<char> buffer;       // Text with a gap at [gapStart, gapEnd)
+    size_t gapStart;
+    size_t gapEnd;
+    std::vector<Entry> entries;     // Tokens with a gap at [tokenGapStart, tokenGapEnd)
+    size_t tokenGapStart;
+    size_t tokenGapEnd;             // The last token is always END_OF_FILE
+    LineIndex lines;                // Built on demand, cut back at every edit
+
+    size_t gapLength() const { return gapEnd - gapStart; }
+    size_t entryIndex(size_t index) const {
+        return index < tokenGapStart ? index : index + (tokenGapEnd - tokenGapStart);
+    }
+    size_t positionAt(size_t index) const;
+    // Copies the text in [begin, end) to 'out', skipping the gap
+    void copyText(size_t begin, size_t end, char* out) const;
+
+    // Moves the gaps, keeping at least 'room' bytes or entries free
+    void moveGap(size_t offset, size_t room);
+    void moveTokenGap(size_t index, size_t room);
+    size_t findRestart(size_t offset) const;
+
+public:
+    explicit IncrementalLexer(std::string_view source);
+
+    IncrementalLexer(const IncrementalLexer&) = delete;
+    IncrementalLexer& operator=(const IncrementalLexer&) = delete;
+
+    size_t length() const { return buffer.size() - gapLength(); }
+    // Copy of the current text
+    std::string getText() const;
+
+    size_t tokenCount() const { return entries.size() - (tokenGapEnd - tokenGapStart); }
+    // Token 'index' of the current text, valid until the next edit
+    Token token(size_t index) const;
+    // Same tokens as Lexer::tokenize() on the current text
+    std::vector<Token> getTokens() const;
+
+    // Applies the edit, clamped to the text, and returns the token delta
+    TokenDelta applyEdit(const TextEdit& edit);
+
+    // Line and column of an offset in the current text. The line index is
+    // cut back at every edit, so this costs the distance from the last edit.
+    SourceLocation locate(size_t position);
+};
+
+#endif // INCREMENTAL_LEXER_H
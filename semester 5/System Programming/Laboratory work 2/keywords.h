@@ -0,0 +1,185 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Visual Basic reserved words (case-insensitive) and a compile-time perfect
+// hash over them. The table is built with the hash-and-displace scheme:
+// every word lands in one of BUCKET_COUNT first-level buckets, and each
+// bucket gets a displacement that moves all of its words into free slots of
+// the final table. Lookup is one hash pass over the candidate plus a single
+// case-insensitive comparison, and never allocates.
+namespace keywords {
+
+constexpr std::string_view RESERVED_WORDS[] = {
+    "If", "Then", "Else", "ElseIf", "End", "Sub", "Function", "Dim", "As",
+    "Integer", "String", "Boolean", "Double", "Single", "Long", "Short",
+    "Byte", "Char", "Date", "Object", "Variant", "Void",
+    "For", "Next", "While", "Wend", "Do", "Loop", "Until", "Step",
+    "Select", "Case", "Is", "To",
+    "Public", "Private", "Protected", "Friend", "Static",
+    "Class", "Module", "Namespace", "Imports", "Inherits",
+    "Return", "Exit", "Continue", "GoTo", "On", "Error", "Resume",
+    "Try", "Catch", "Finally", "Throw",
+    "And", "Or", "Not", "Xor", "Mod",
+    "True", "False", "Nothing", "Me", "MyBase", "MyClass",
+    "ByVal", "ByRef", "Optional", "ParamArray",
+    "Const", "ReadOnly", "WriteOnly", "Property", "Get", "Set",
+    "AddHandler", "RemoveHandler", "RaiseEvent", "Event",
+    "With", "End", "Structure", "Enum", "Interface",
+    "Inherits", "Implements", "Overloads", "Overrides", "Overridable",
+    "MustOverride", "NotInheritable", "NotOverridable", "Shadows",
+    "Shared", "MustInherit", "Partial", "Async", "Await",
+    "Let", "Set", "Call", "New", "TypeOf", "IsNot",
+    "Option", "Explicit", "Strict", "Compare", "On", "Off",
+    "ReDim", "Preserve", "Erase", "LBound", "UBound",
+    "On", "Error", "Resume", "Next", "GoSub", "Return",
+    "Stop", "End", "ChDir", "ChDrive", "Close", "Reset",
+    "Lock", "Unlock", "Open", "Input", "Output", "Append",
+    "Binary", "Random", "Access", "Read", "Write", "ReadWrite",
+    "Seek", "Loc", "LOF", "EOF", "FreeFile", "FileAttr",
+    "Get", "Put", "Width", "Print", "PrintLine", "Write", "WriteLine",
+    "Input", "InputString", "LineInput", "Lock", "Unlock",
+    "Name", "Kill", "MkDir", "RmDir", "FileCopy", "FileDateTime",
+    "FileLen", "GetAttr", "SetAttr", "Dir", "CurDir", "ChDir", "ChDrive"
+};
+
+constexpr size_t WORD_COUNT = sizeof(RESERVED_WORDS) / sizeof(RESERVED_WORDS[0]);
+constexpr size_t TABLE_SIZE = 256;     // Power of two, slot index fits in uint8_t
+constexpr size_t BUCKET_COUNT = 64;
+constexpr uint8_t EMPTY_SLOT = 0xFF;
+
+static_assert(WORD_COUNT < EMPTY_SLOT, "Keyword index must fit in a table slot");
+
+constexpr char toUpper(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+constexpr bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (toUpper(a[i]) != toUpper(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive FNV-1a
+constexpr uint32_t baseHash(std::string_view word) {
+    uint32_t h = 2166136261u;
+    for (char c : word) {
+        h ^= static_cast<unsigned char>(toUpper(c));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr size_t bucketOf(uint32_t h) {
+    return (h >> 8) % BUCKET_COUNT;
+}
+
+constexpr size_t slotOf(uint32_t h, uint32_t displacement) {
+    uint32_t x = h + displacement * 0x9E3779B9u;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x & (TABLE_SIZE - 1);
+}
+
+struct PerfectHashTable {
+    std::array<uint8_t, BUCKET_COUNT> displacements;
+    std::array<uint8_t, TABLE_SIZE> slots;   // Index into RESERVED_WORDS or EMPTY_SLOT
+    bool valid;
+};
+
+constexpr PerfectHashTable buildTable() {
+    PerfectHashTable table{};
+    table.valid = true;
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        table.slots[i] = EMPTY_SLOT;
+    }
+
+    // Group unique words by bucket (the list repeats a few words)
+    std::array<std::array<uint8_t, WORD_COUNT>, BUCKET_COUNT> members{};
+    std::array<size_t, BUCKET_COUNT> memberCount{};
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        bool duplicate = false;
+        for (size_t j = 0; j < i && !duplicate; j++) {
+            duplicate = equalsIgnoreCase(RESERVED_WORDS[i], RESERVED_WORDS[j]);
+        }
+        if (!duplicate) {
+            size_t b = bucketOf(baseHash(RESERVED_WORDS[i]));
+            members[b][memberCount[b]++] = static_cast<uint8_t>(i);
+        }
+    }
+
+    // Place the largest buckets first, they are the hardest to fit
+    std::array<size_t, BUCKET_COUNT> order{};
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        order[i] = i;
+    }
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        for (size_t j = i + 1; j < BUCKET_COUNT; j++) {
+            if (memberCount[order[j]] > memberCount[order[i]]) {
+                size_t tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+            }
+        }
+    }
+
+    for (size_t k = 0; k < BUCKET_COUNT; k++) {
+        size_t b = order[k];
+        if (memberCount[b] == 0) {
+            break;
+        }
+
+        bool placed = false;
+        for (uint32_t d = 0; d < 256 && !placed; d++) {
+            std::array<size_t, WORD_COUNT> candidate{};
+            bool fits = true;
+            for (size_t m = 0; m < memberCount[b] && fits; m++) {
+                candidate[m] = slotOf(baseHash(RESERVED_WORDS[members[b][m]]), d);
+                fits = table.slots[candidate[m]] == EMPTY_SLOT;
+                for (size_t n = 0; n < m && fits; n++) {
+                    fits = candidate[n] != candidate[m];
+                }
+            }
+            if (fits) {
+                for (size_t m = 0; m < memberCount[b]; m++) {
+                    table.slots[candidate[m]] = members[b][m];
+                }
+                table.displacements[b] = static_cast<uint8_t>(d);
+                placed = true;
+            }
+        }
+
+        if (!placed) {
+            table.valid = false;
+            return table;
+        }
+    }
+
+    return table;
+}
+
+constexpr PerfectHashTable TABLE = buildTable();
+static_assert(TABLE.valid, "No perfect hash displacement found for the reserved word list");
+
+inline bool isReservedWord(std::string_view word) {
+    uint32_t h = baseHash(word);
+    uint8_t index = TABLE.slots[slotOf(h, TABLE.displacements[bucketOf(h)])];
+    return index != EMPTY_SLOT && equalsIgnoreCase(word, RESERVED_WORDS[index]);
+}
+
+} // namespace keywords
+
+#endif // KEYWORDS_H
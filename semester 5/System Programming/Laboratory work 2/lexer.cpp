@@ -1,10 +1,21 @@
 #include "lexer.h"
-#include <iostream>
-#include <sstream>
+#include "keywords.h"
+#include "dfa.h"
+#include "simd_scan.h"
+#include "lexer_stats.h"
+#include "thread_pool.h"
+#include "output_writer.h"
+#include "token_buffer.h"
+#include "token_cache.h"
 #include <algorithm>
-#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
 #include <vector>
 
+// Inputs smaller than this are not worth splitting across threads
+static const size_t PARALLEL_MIN_BYTES = 1 << 20;
+
 // ANSI color codes
 #define COLOR_RESET "\033[0m"
 #define COLOR_NUMBER "\033[33m"      // Yellow
@@ -17,553 +28,517 @@
 #define COLOR_PREPROCESSOR "\033[34m" // Blue
 #define COLOR_ERROR "\033[91m"         // Bright Red
 
-Lexer::Lexer(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+Lexer::Lexer(const std::string& filename) : cursor(0), opened(false) {
+    opened = source.open(filename);
+    if (!opened) {
         std::cerr << "Error: Cannot open file " << filename << std::endl;
-        source = "";
-        return;
     }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    source = buffer.str();
-    file.close();
-    
-    position = 0;
-    line = 1;
-    column = 1;
 }
 
-bool Lexer::isWhitespace(char c) {
-    return c == ' ' || c == '\t' || c == '\r';
+bool Lexer::isReservedWord(std::string_view word) {
+    return keywords::isReservedWord(word);
 }
 
-bool Lexer::isDigit(char c) {
-    return std::isdigit(static_cast<unsigned char>(c));
+// "REM" followed by a blank, a newline or the end of input starts a comment
+static bool isRemComment(const char* data, size_t length, size_t start, size_t end) {
+    if (end - start != 3 || !keywords::equalsIgnoreCase(std::string_view(data + start, 3), "REM")) {
+        return false;
+    }
+    if (end >= length) {
+        return true;
+    }
+    uint8_t next = dfa::CHAR_CLASS[static_cast<unsigned char>(data[end])];
+    return next == dfa::C_BLANK || next == dfa::C_NEWLINE;
 }
 
-bool Lexer::isHexDigit(char c) {
-    return std::isxdigit(static_cast<unsigned char>(c));
-}
+// Runs the DFA from 'state' at 'pos' and returns the end of the longest
+// accepted match, storing its accept code (ACCEPT_NONE if nothing matched)
+static size_t runDfa(const char* data, size_t length, size_t pos, uint8_t state, uint8_t& accept) {
+    size_t acceptEnd = pos;
+    accept = dfa::ACCEPT[state];
 
-bool Lexer::isLetter(char c) {
-    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
-}
+    while (pos < length) {
+        state = dfa::TRANSITIONS[state][dfa::CHAR_CLASS[static_cast<unsigned char>(data[pos])]];
+        if (state == dfa::S_DEAD) {
+            break;
+        }
+        pos++;
 
-bool Lexer::isIdentifierChar(char c) {
-    return isLetter(c) || isDigit(c) || c == '_';
-}
+        switch (dfa::RUNS[state]) {
+            case dfa::RUN_BLANKS:
+                pos = simd::skipBlanks(data, pos, length);
+                break;
+            case dfa::RUN_LINE:
+                pos = simd::findLineEnd(data, pos, length);
+                break;
+            case dfa::RUN_STRING:
+                pos = simd::findStringStop(data, pos, length);
+                break;
+            default:
+                break;
+        }
 
-char Lexer::peek() {
-    if (position >= source.length()) {
-        return '\0';
+        if (dfa::ACCEPT[state] != dfa::ACCEPT_NONE) {
+            accept = dfa::ACCEPT[state];
+            acceptEnd = pos;
+        }
     }
-    return source[position];
-}
 
-char Lexer::advance() {
-    if (position >= source.length()) {
-        return '\0';
-    }
-    
-    char c = source[position++];
-    if (c == '\n') {
-        line++;
-        column = 1;
-    } else {
-        column++;
-    }
-    return c;
+    return acceptEnd;
 }
 
-void Lexer::skipWhitespace() {
-    while (position < source.length() && isWhitespace(source[position])) {
-        advance();
+size_t Lexer::scanToken(const char* data, size_t length, size_t from,
+                        size_t& tokenStart, TokenType& type) {
+    size_t start = from;
+    for (;;) {
+        LEXER_STATS_START(startedAt);
+        uint8_t accept;
+        size_t end = runDfa(data, length, start, dfa::S_START, accept);
+
+        if (accept == dfa::ACCEPT_SKIP) {
+            LEXER_STATS_RECORD(stats::BLANKS, end - start, startedAt);
+            start = end;
+            continue;
+        }
+
+        tokenStart = start;
+        if (accept == dfa::ACCEPT_NONE) {
+            // End of input or '\0'
+            type = TokenType::END_OF_FILE;
+            return start;
+        }
+
+        type = static_cast<TokenType>(accept);
+        if (type == TokenType::IDENTIFIER) {
+            if (isRemComment(data, length, start, end)) {
+                type = TokenType::COMMENT;
+                end = runDfa(data, length, end, dfa::S_COMMENT, accept);
+            } else {
+                LEXER_STATS_START(lookupAt);
+                bool reserved = keywords::isReservedWord(std::string_view(data + start, end - start));
+                LEXER_STATS_RECORD(stats::RESERVED_LOOKUP, end - start, lookupAt);
+                if (reserved) {
+                    type = TokenType::RESERVED_WORD;
+                }
+            }
+        }
+        LEXER_STATS_RECORD(static_cast<size_t>(type), end - start, startedAt);
+        return end;
     }
 }
 
-Token Lexer::scanNumber() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    // Check for hexadecimal
-    if (peek() == '&' && position + 1 < source.length()) {
-        char next = source[position + 1];
-        if (next == 'H' || next == 'h') {
-            advance(); // consume '&'
-            advance(); // consume 'H' or 'h'
-            value = "&H";
-            
-            while (position < source.length() && isHexDigit(peek())) {
-                value += advance();
-            }
-            
-            // Check for type suffix
-            if (peek() == '&' || peek() == '!' || peek() == '#') {
-                value += advance();
-            }
-            
-            return Token(TokenType::HEXADECIMAL, value, startLine, startCol, startPos);
+size_t Lexer::scanRange(const char* data, size_t from, size_t end, std::vector<Token>& out) {
+    size_t pos = from;
+    for (;;) {
+        size_t tokenStart;
+        TokenType type;
+        size_t tokenEnd = scanToken(data, end, pos, tokenStart, type);
+        if (type == TokenType::END_OF_FILE) {
+            return tokenStart;
         }
+
+        out.push_back(Token(type, std::string_view(data + tokenStart, tokenEnd - tokenStart), tokenStart));
+        pos = tokenEnd;
     }
-    
-    // Decimal integer or floating point
-    while (position < source.length() && isDigit(peek())) {
-        value += advance();
+}
+
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+    source.loadAll();
+
+    cursor = scanRange(source.data(), 0, source.length(), tokens);
+
+    tokens.push_back(Token(TokenType::END_OF_FILE, std::string_view(), cursor));
+    return tokens;
+}
+
+std::string_view Lexer::contents() {
+    source.loadAll();
+    return std::string_view(source.data(), source.length());
+}
+
+TokenBuffer Lexer::tokenizeCompact() {
+    source.loadAll();
+    const char* data = source.data();
+    size_t length = source.length();
+
+    TokenBuffer tokens(data);
+    if (length > UINT32_MAX) {
+        std::cerr << "Error: Source too large for compact token storage" << std::endl;
+        return tokens;
     }
-    
-    // Check for floating point
-    if (peek() == '.' && position + 1 < source.length() && isDigit(source[position + 1])) {
-        value += advance(); // consume '.'
-        while (position < source.length() && isDigit(peek())) {
-            value += advance();
+
+    size_t pos = 0;
+    for (;;) {
+        size_t tokenStart;
+        TokenType type;
+        size_t tokenEnd = scanToken(data, length, pos, tokenStart, type);
+        tokens.push(type, tokenStart, tokenEnd - tokenStart);
+        if (type == TokenType::END_OF_FILE) {
+            tokens.indexLines(tokenStart);
+            break;
         }
-        
-        // Check for exponent
-        if (peek() == 'E' || peek() == 'e') {
-            value += advance();
-            if (peek() == '+' || peek() == '-') {
-                value += advance();
-            }
-            while (position < source.length() && isDigit(peek())) {
-                value += advance();
-            }
+        pos = tokenEnd;
+    }
+    return tokens;
+}
+
+// Finds the first newline at or after 'from' that no token continues past,
+// or returns length. Only a string escape can swallow a newline, so newlines
+// right after a backslash are skipped.
+static size_t findSafeNewline(const char* data, size_t length, size_t from) {
+    size_t pos = from;
+    while (pos < length) {
+        const void* found = std::memchr(data + pos, '\n', length - pos);
+        if (!found) {
+            return length;
         }
-        
-        // Type suffix
-        if (peek() == '!' || peek() == '#' || peek() == '@') {
-            value += advance();
+        size_t newline = static_cast<const char*>(found) - data;
+        if (newline == 0 || data[newline - 1] != '\\') {
+            return newline;
         }
-        
-        return Token(TokenType::FLOATING_POINT, value, startLine, startCol, startPos);
+        pos = newline + 1;
     }
-    
-    // Type suffix for integer
-    if (peek() == '&' || peek() == '!' || peek() == '#' || peek() == '@' || peek() == '%') {
-        value += advance();
+    return length;
+}
+
+std::vector<Token> Lexer::tokenizeParallel(size_t threadCount) {
+    source.loadAll();
+    const char* data = source.data();
+    size_t length = source.length();
+
+    ThreadPool pool(threadCount);
+    if (pool.size() == 1 || length < PARALLEL_MIN_BYTES) {
+        return tokenize();
     }
-    
-    return Token(TokenType::DECIMAL_INTEGER, value, startLine, startCol, startPos);
-}
-
-Token Lexer::scanString() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    char quote = advance(); // consume opening quote
-    value += quote;
-    
-    bool isChar = false;
-    
-    while (position < source.length()) {
-        char c = peek();
-        if (c == '\0') {
+
+    // Several chunks per thread so uneven chunks still balance out
+    size_t chunkCount = pool.size() * 4;
+    size_t chunkSize = length / chunkCount + 1;
+    std::vector<size_t> bounds(1, 0);
+    while (bounds.back() < length) {
+        size_t newline = findSafeNewline(data, length, bounds.back() + chunkSize);
+        bounds.push_back(newline < length ? newline + 1 : length);
+    }
+    chunkCount = bounds.size() - 1;
+
+    // Tokens carry only offsets, so chunks need no fix-up after scanning
+    std::vector<std::vector<Token>> chunkTokens(chunkCount);
+    std::vector<size_t> chunkEnds(chunkCount);
+    pool.parallelFor(chunkCount, [&](size_t i) {
+        chunkTokens[i].reserve((bounds[i + 1] - bounds[i]) / 4);
+        chunkEnds[i] = scanRange(data, bounds[i], bounds[i + 1], chunkTokens[i]);
+    });
+
+    // A '\0' stops the sequential lexer for good, so drop every chunk after
+    // the first one that stopped early
+    size_t usedChunks = chunkCount;
+    for (size_t i = 0; i < chunkCount; i++) {
+        if (chunkEnds[i] < bounds[i + 1]) {
+            usedChunks = i + 1;
             break;
         }
-        
-        if (c == quote) {
-            value += advance();
-            // Check for character constant suffix
-            if (peek() == 'C' || peek() == 'c') {
-                value += advance();
-                isChar = true;
+    }
+
+    std::vector<size_t> firstToken(usedChunks + 1, 0);
+    for (size_t i = 0; i < usedChunks; i++) {
+        firstToken[i + 1] = firstToken[i] + chunkTokens[i].size();
+    }
+
+    std::vector<Token> tokens(firstToken[usedChunks], Token(TokenType::END_OF_FILE, std::string_view()));
+    pool.parallelFor(usedChunks, [&](size_t i) {
+        std::copy(chunkTokens[i].begin(), chunkTokens[i].end(), tokens.begin() + firstToken[i]);
+        std::vector<Token>().swap(chunkTokens[i]);
+    });
+
+    cursor = chunkEnds[usedChunks - 1];
+    tokens.push_back(Token(TokenType::END_OF_FILE, std::string_view(), cursor));
+    return tokens;
+}
+
+void Lexer::bufferNextToken() {
+    for (;;) {
+        const char* data = source.data();
+        size_t length = source.length();
+        size_t pos = cursor - source.base();
+
+        // A token is complete once the first safe newline after its start,
+        // or a '\0' that stops the scan, is in the window
+        while (pos < length) {
+            uint8_t charClass = dfa::CHAR_CLASS[static_cast<unsigned char>(data[pos])];
+            if (charClass != dfa::C_BLANK && charClass != dfa::C_NEWLINE) {
+                break;
             }
-            break;
+            pos++;
         }
-        
-        if (c == '\n') {
-            // Unterminated string
-            break;
+        if (pos < length && (data[pos] == '\0' || findSafeNewline(data, length, pos) < length)) {
+            return;
         }
-        
-        // Handle escape sequences
-        if (c == '\\') {
-            value += advance();
-            if (position < source.length()) {
-                value += advance();
-            }
-        } else {
-            value += advance();
+
+        if (!fillWindow(cursor)) {
+            return;
         }
     }
-    
-    TokenType type = isChar ? TokenType::CHARACTER_CONSTANT : TokenType::STRING_CONSTANT;
-    return Token(type, value, startLine, startCol, startPos);
-}
-
-Token Lexer::scanComment() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    // Check for REM keyword
-    if (position + 2 < source.length() && 
-        (source[position] == 'R' || source[position] == 'r') &&
-        (source[position + 1] == 'E' || source[position + 1] == 'e') &&
-        (source[position + 2] == 'M' || source[position + 2] == 'm') &&
-        (position + 3 >= source.length() || isWhitespace(source[position + 3]) || source[position + 3] == '\n')) {
-        value += advance(); // R
-        value += advance(); // E
-        value += advance(); // M
-        skipWhitespace();
-    } else if (peek() == '\'') {
-        value += advance(); // consume '
+}
+
+bool Lexer::fillWindow(size_t keepFrom) {
+    if (source.exhausted()) {
+        return false;
     }
-    
-    // Read until end of line
-    while (position < source.length() && peek() != '\n' && peek() != '\0') {
-        value += advance();
+    lines.extend(source.data(), source.base(), keepFrom);
+    lines.discardBefore(keepFrom);
+    return source.fill(keepFrom);
+}
+
+Token Lexer::nextToken() {
+    if (!source.exhausted()) {
+        bufferNextToken();
     }
-    
-    return Token(TokenType::COMMENT, value, startLine, startCol, startPos);
-}
-
-Token Lexer::scanPreprocessor() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    value += advance(); // consume '#'
-    
-    // Read directive name
-    while (position < source.length() && isLetter(peek())) {
-        value += advance();
+
+    const char* data = source.data();
+    size_t base = source.base();
+
+    size_t tokenStart;
+    TokenType type;
+    size_t tokenEnd = scanToken(data, source.length(), cursor - base, tokenStart, type);
+
+    cursor = base + tokenEnd;
+    if (type == TokenType::END_OF_FILE) {
+        return Token(type, std::string_view(), base + tokenStart);
     }
-    
-    // Read rest of the line (including whitespace)
-    while (position < source.length() && peek() != '\n' && peek() != '\0') {
-        value += advance();
+    return Token(type, std::string_view(data + tokenStart, tokenEnd - tokenStart), base + tokenStart);
+}
+
+TokenIterator::TokenIterator(Lexer* source)
+    : lexer(source), current(source->nextToken()) {}
+
+TokenIterator& TokenIterator::operator++() {
+    if (current.type == TokenType::END_OF_FILE) {
+        lexer = nullptr;
+    } else {
+        current = lexer->nextToken();
     }
-    
-    return Token(TokenType::PREPROCESSOR_DIRECTIVE, value, startLine, startCol, startPos);
-}
-
-bool Lexer::isReservedWord(const std::string& word) {
-    // Visual Basic reserved words (case-insensitive)
-    static const std::vector<std::string> reservedWords = {
-        "If", "Then", "Else", "ElseIf", "End", "Sub", "Function", "Dim", "As",
-        "Integer", "String", "Boolean", "Double", "Single", "Long", "Short",
-        "Byte", "Char", "Date", "Object", "Variant", "Void",
-        "For", "Next", "While", "Wend", "Do", "Loop", "Until", "Step",
-        "Select", "Case", "Is", "To",
-        "Public", "Private", "Protected", "Friend", "Static",
-        "Class", "Module", "Namespace", "Imports", "Inherits",
-        "Return", "Exit", "Continue", "GoTo", "On", "Error", "Resume",
-        "Try", "Catch", "Finally", "Throw",
-        "And", "Or", "Not", "Xor", "Mod",
-        "True", "False", "Nothing", "Me", "MyBase", "MyClass",
-        "ByVal", "ByRef", "Optional", "ParamArray",
-        "Const", "ReadOnly", "WriteOnly", "Property", "Get", "Set",
-        "AddHandler", "RemoveHandler", "RaiseEvent", "Event",
-        "With", "End", "Structure", "Enum", "Interface",
-        "Inherits", "Implements", "Overloads", "Overrides", "Overridable",
-        "MustOverride", "NotInheritable", "NotOverridable", "Shadows",
-        "Shared", "MustInherit", "Partial", "Async", "Await",
-        "Let", "Set", "Call", "New", "TypeOf", "IsNot",
-        "Option", "Explicit", "Strict", "Compare", "On", "Off",
-        "ReDim", "Preserve", "Erase", "LBound", "UBound",
-        "On", "Error", "Resume", "Next", "GoSub", "Return",
-        "Stop", "End", "ChDir", "ChDrive", "Close", "Reset",
-        "Lock", "Unlock", "Open", "Input", "Output", "Append",
-        "Binary", "Random", "Access", "Read", "Write", "ReadWrite",
-        "Seek", "Loc", "LOF", "EOF", "FreeFile", "FileAttr",
-        "Get", "Put", "Width", "Print", "PrintLine", "Write", "WriteLine",
-        "Input", "InputString", "LineInput", "Lock", "Unlock",
-        "Name", "Kill", "MkDir", "RmDir", "FileCopy", "FileDateTime",
-        "FileLen", "GetAttr", "SetAttr", "Dir", "CurDir", "ChDir", "ChDrive"
-    };
-    
-    std::string upperWord = word;
-    std::transform(upperWord.begin(), upperWord.end(), upperWord.begin(), ::toupper);
-    
-    for (const auto& reserved : reservedWords) {
-        std::string upperReserved = reserved;
-        std::transform(upperReserved.begin(), upperReserved.end(), upperReserved.begin(), ::toupper);
-        if (upperWord == upperReserved) {
-            return true;
-        }
+    return *this;
+}
+
+SourceLocation Lexer::locate(size_t position) {
+    lines.extend(source.data(), source.base(), position);
+    return lines.locate(position);
+}
+
+std::string_view Lexer::text(size_t begin, size_t end) const {
+    return std::string_view(source.data() + (begin - source.base()), end - begin);
+}
+
+const char* tokenTypeName(TokenType type) {
+    switch (type) {
+        case TokenType::DECIMAL_INTEGER:
+            return "DECIMAL_INTEGER";
+        case TokenType::FLOATING_POINT:
+            return "FLOATING_POINT";
+        case TokenType::HEXADECIMAL:
+            return "HEXADECIMAL";
+        case TokenType::STRING_CONSTANT:
+            return "STRING_CONSTANT";
+        case TokenType::CHARACTER_CONSTANT:
+            return "CHARACTER_CONSTANT";
+        case TokenType::PREPROCESSOR_DIRECTIVE:
+            return "PREPROCESSOR_DIRECTIVE";
+        case TokenType::COMMENT:
+            return "COMMENT";
+        case TokenType::RESERVED_WORD:
+            return "RESERVED_WORD";
+        case TokenType::OPERATOR:
+            return "OPERATOR";
+        case TokenType::DELIMITER:
+            return "DELIMITER";
+        case TokenType::IDENTIFIER:
+            return "IDENTIFIER";
+        case TokenType::UNRECOGNIZED:
+            return "UNRECOGNIZED";
+        case TokenType::END_OF_FILE:
+            return "END_OF_FILE";
     }
-    
-    return false;
-}
-
-Token Lexer::scanIdentifierOrKeyword() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    while (position < source.length() && isIdentifierChar(peek())) {
-        value += advance();
+    return "";
+}
+
+static const char* tokenColor(TokenType type) {
+    switch (type) {
+        case TokenType::DECIMAL_INTEGER:
+        case TokenType::FLOATING_POINT:
+        case TokenType::HEXADECIMAL:
+            return COLOR_NUMBER;
+        case TokenType::STRING_CONSTANT:
+        case TokenType::CHARACTER_CONSTANT:
+            return COLOR_STRING;
+        case TokenType::COMMENT:
+            return COLOR_COMMENT;
+        case TokenType::RESERVED_WORD:
+            return COLOR_KEYWORD;
+        case TokenType::OPERATOR:
+            return COLOR_OPERATOR;
+        case TokenType::DELIMITER:
+            return COLOR_DELIMITER;
+        case TokenType::PREPROCESSOR_DIRECTIVE:
+            return COLOR_PREPROCESSOR;
+        case TokenType::IDENTIFIER:
+            return COLOR_IDENTIFIER;
+        case TokenType::UNRECOGNIZED:
+            return COLOR_ERROR;
+        default:
+            return COLOR_RESET;
     }
-    
-    TokenType type = isReservedWord(value) ? TokenType::RESERVED_WORD : TokenType::IDENTIFIER;
-    return Token(type, value, startLine, startCol, startPos);
-}
-
-Token Lexer::scanOperator() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    char c = peek();
-    
-    // Multi-character operators
-    if (c == '<') {
-        value += advance();
-        if (peek() == '=') {
-            value += advance(); // <=
-        } else if (peek() == '>') {
-            value += advance(); // <>
-        } else {
-            // <
-        }
-    } else if (c == '>') {
-        value += advance();
-        if (peek() == '=') {
-            value += advance(); // >=
-        }
-    } else if (c == '=') {
-        value += advance();
-    } else if (c == '+') {
-        value += advance();
-    } else if (c == '-') {
-        value += advance();
-    } else if (c == '*') {
-        value += advance();
-    } else if (c == '/') {
-        value += advance();
-        if (peek() == '=') {
-            value += advance(); // /=
+}
+
+// Tokens are slices of the source, so they keep what the old copied lexemes
+// normalized away; pairs print them the same way: a hex literal with '&H',
+// and a REM comment without the blanks between REM and its text
+static void writeLexeme(std::string_view text, TokenType type, OutputWriter& out) {
+    if (type == TokenType::HEXADECIMAL && text.size() >= 2 && text[1] == 'h') {
+        out.write("&H");
+        text.remove_prefix(2);
+    } else if (type == TokenType::COMMENT && !text.empty() && text[0] != '\'') {
+        out.write(text.substr(0, 3));
+        size_t start = 3;
+        while (start < text.size() && simd::isBlank(text[start])) {
+            start++;
         }
-    } else if (c == '\\') {
-        value += advance(); // Integer division
-    } else if (c == '^') {
-        value += advance(); // Exponentiation
-    } else if (c == '&') {
-        value += advance(); // Concatenation
-    } else {
-        value += advance();
+        text.remove_prefix(start);
     }
-    
-    return Token(TokenType::OPERATOR, value, startLine, startCol, startPos);
+    out.write(text);
 }
 
-Token Lexer::scanDelimiter() {
-    size_t startLine = line;
-    size_t startCol = column;
-    size_t startPos = position;
-    std::string value;
-    
-    value += advance();
-    
-    return Token(TokenType::DELIMITER, value, startLine, startCol, startPos);
+// "<lexeme, TYPE>" without the line end
+static void printPairText(std::string_view text, TokenType type, OutputWriter& out) {
+    out.put('<');
+    writeLexeme(text, type, out);
+    out.write(", ");
+    out.write(tokenTypeName(type));
+    out.put('>');
 }
 
-std::vector<Token> Lexer::tokenize() {
-    tokens.clear();
-    position = 0;
-    line = 1;
-    column = 1;
-    
-    while (position < source.length()) {
-        skipWhitespace();
-        
-        if (position >= source.length()) {
-            break;
-        }
-        
-        char c = peek();
-        
-        if (c == '\0') {
-            break;
-        }
-        
-        if (c == '\n') {
-            advance();
-            continue;
-        }
-        
-        // Numbers
-        if (isDigit(c) || (c == '&' && position + 1 < source.length() && 
-            (source[position + 1] == 'H' || source[position + 1] == 'h'))) {
-            tokens.push_back(scanNumber());
-        }
-        // Strings
-        else if (c == '"') {
-            tokens.push_back(scanString());
-        }
-        // Comments
-        else if (c == '\'' || (position + 2 < source.length() && 
-                 (c == 'R' || c == 'r') && 
-                 (source[position + 1] == 'E' || source[position + 1] == 'e') &&
-                 (source[position + 2] == 'M' || source[position + 2] == 'm') &&
-                 (position + 3 >= source.length() || isWhitespace(source[position + 3]) || source[position + 3] == '\n'))) {
-            tokens.push_back(scanComment());
-        }
-        // Preprocessor
-        else if (c == '#') {
-            tokens.push_back(scanPreprocessor());
-        }
-        // Identifiers and keywords
-        else if (isLetter(c)) {
-            tokens.push_back(scanIdentifierOrKeyword());
-        }
-        // Operators
-        else if (c == '<' || c == '>' || c == '=' || c == '+' || c == '-' || 
-                 c == '*' || c == '/' || c == '\\' || c == '^' || c == '&') {
-            tokens.push_back(scanOperator());
-        }
-        // Delimiters
-        else if (c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || 
-                 c == '}' || c == ',' || c == ';' || c == ':' || c == '.') {
-            tokens.push_back(scanDelimiter());
-        }
-        // Unrecognized
-        else {
-            size_t startLine = line;
-            size_t startCol = column;
-            size_t startPos = position;
-            std::string value;
-            value += advance();
-            tokens.push_back(Token(TokenType::UNRECOGNIZED, value, startLine, startCol, startPos));
-        }
+static void printErrorLocation(SourceLocation at, OutputWriter& out) {
+    out.write(" [ERROR at line ");
+    out.writeNumber(at.line);
+    out.write(", column ");
+    out.writeNumber(at.column);
+    out.put(']');
+}
+
+// Only errors need a line and column, so only they pay for the lookup
+void Lexer::printPair(const Token& token, OutputWriter& out) {
+    printPairText(token.value, token.type, out);
+    if (token.type == TokenType::UNRECOGNIZED) {
+        printErrorLocation(locate(token.position), out);
     }
-    
-    tokens.push_back(Token(TokenType::END_OF_FILE, "", line, column, position));
-    return tokens;
+    out.put('\n');
+}
+
+static void printColoredToken(const Token& token, OutputWriter& out) {
+    out.write(tokenColor(token.type));
+    out.write(token.value);
+    out.write(COLOR_RESET);
 }
 
-void Lexer::printTokens() {
+void Lexer::printTokens(OutputWriter& out) {
+    for (const Token& token : *this) {
+        printPair(token, out);
+    }
+}
+
+void Lexer::printTokens(const std::vector<Token>& tokens, OutputWriter& out) {
     for (const auto& token : tokens) {
-        std::string typeStr;
-        switch (token.type) {
-            case TokenType::DECIMAL_INTEGER:
-                typeStr = "DECIMAL_INTEGER";
-                break;
-            case TokenType::FLOATING_POINT:
-                typeStr = "FLOATING_POINT";
-                break;
-            case TokenType::HEXADECIMAL:
-                typeStr = "HEXADECIMAL";
-                break;
-            case TokenType::STRING_CONSTANT:
-                typeStr = "STRING_CONSTANT";
-                break;
-            case TokenType::CHARACTER_CONSTANT:
-                typeStr = "CHARACTER_CONSTANT";
-                break;
-            case TokenType::PREPROCESSOR_DIRECTIVE:
-                typeStr = "PREPROCESSOR_DIRECTIVE";
-                break;
-            case TokenType::COMMENT:
-                typeStr = "COMMENT";
-                break;
-            case TokenType::RESERVED_WORD:
-                typeStr = "RESERVED_WORD";
-                break;
-            case TokenType::OPERATOR:
-                typeStr = "OPERATOR";
-                break;
-            case TokenType::DELIMITER:
-                typeStr = "DELIMITER";
-                break;
-            case TokenType::IDENTIFIER:
-                typeStr = "IDENTIFIER";
-                break;
-            case TokenType::UNRECOGNIZED:
-                typeStr = "UNRECOGNIZED";
-                break;
-            case TokenType::END_OF_FILE:
-                typeStr = "END_OF_FILE";
-                break;
-        }
-        
-        std::cout << "<" << token.value << ", " << typeStr << ">";
-        if (token.type == TokenType::UNRECOGNIZED) {
-            std::cout << " [ERROR at line " << token.line << ", column " << token.column << "]";
+        printPair(token, out);
+    }
+}
+
+void Lexer::printColored(OutputWriter& out) {
+    size_t sourcePos = cursor;
+
+    for (;;) {
+        Token token = nextToken();
+        if (token.type == TokenType::END_OF_FILE) {
+            break;
         }
-        std::cout << std::endl;
+
+        // Print everything before this token, then the colored token
+        out.write(text(sourcePos, token.position));
+        printColoredToken(token, out);
+        sourcePos = token.position + token.value.length();
     }
+
+    // Print any remaining source (everything after a '\0')
+    out.write(text(sourcePos, source.base() + source.length()));
+    while (source.fill(source.base() + source.length())) {
+        out.write(std::string_view(source.data(), source.length()));
+    }
+    out.put('\n');
 }
 
-void Lexer::printColored() {
-    // Sort tokens by position for easier processing
-    std::vector<Token> sortedTokens = tokens;
-    std::sort(sortedTokens.begin(), sortedTokens.end(), 
-              [](const Token& a, const Token& b) { return a.position < b.position; });
-    
+void Lexer::printColored(const std::vector<Token>& tokens, OutputWriter& out) {
     size_t sourcePos = 0;
-    size_t tokenIndex = 0;
-    
-    while (sourcePos < source.length() && tokenIndex < sortedTokens.size()) {
-        const Token& token = sortedTokens[tokenIndex];
-        
-        // Skip END_OF_FILE token
+
+    for (const Token& token : tokens) {
         if (token.type == TokenType::END_OF_FILE) {
-            tokenIndex++;
-            continue;
-        }
-        
-        // Print everything before this token
-        while (sourcePos < token.position && sourcePos < source.length()) {
-            std::cout << source[sourcePos++];
-        }
-        
-        // Print colored token
-        std::string color;
-        switch (token.type) {
-            case TokenType::DECIMAL_INTEGER:
-            case TokenType::FLOATING_POINT:
-            case TokenType::HEXADECIMAL:
-                color = COLOR_NUMBER;
-                break;
-            case TokenType::STRING_CONSTANT:
-            case TokenType::CHARACTER_CONSTANT:
-                color = COLOR_STRING;
-                break;
-            case TokenType::COMMENT:
-                color = COLOR_COMMENT;
-                break;
-            case TokenType::RESERVED_WORD:
-                color = COLOR_KEYWORD;
-                break;
-            case TokenType::OPERATOR:
-                color = COLOR_OPERATOR;
-                break;
-            case TokenType::DELIMITER:
-                color = COLOR_DELIMITER;
-                break;
-            case TokenType::PREPROCESSOR_DIRECTIVE:
-                color = COLOR_PREPROCESSOR;
-                break;
-            case TokenType::IDENTIFIER:
-                color = COLOR_IDENTIFIER;
-                break;
-            case TokenType::UNRECOGNIZED:
-                color = COLOR_ERROR;
-                break;
-            default:
-                color = COLOR_RESET;
+            break;
         }
-        
-        std::cout << color << token.value << COLOR_RESET;
-        sourcePos += token.value.length();
-        tokenIndex++;
+
+        // Print everything before this token, then the colored token
+        out.write(text(sourcePos, token.position));
+        printColoredToken(token, out);
+        sourcePos = token.position + token.value.length();
     }
-    
+
     // Print any remaining source
-    while (sourcePos < source.length()) {
-        std::cout << source[sourcePos++];
+    out.write(text(sourcePos, source.length()));
+    out.put('\n');
+}
+
+// Printers shared by the array-backed token stores (TokenBuffer, CachedTokens)
+template <typename Tokens>
+static void printTokenArrays(const Tokens& tokens, OutputWriter& out) {
+    for (size_t i = 0; i < tokens.size(); i++) {
+        printPairText(tokens.text(i), tokens.type(i), out);
+        if (tokens.type(i) == TokenType::UNRECOGNIZED) {
+            printErrorLocation(SourceLocation{tokens.line(i), tokens.column(i)}, out);
+        }
+        out.put('\n');
+    }
+}
+
+template <typename Tokens>
+void Lexer::printColoredArrays(const Tokens& tokens, OutputWriter& out) {
+    size_t sourcePos = 0;
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        TokenType type = tokens.type(i);
+        if (type == TokenType::END_OF_FILE) {
+            break;
+        }
+
+        out.write(text(sourcePos, tokens.offset(i)));
+        out.write(tokenColor(type));
+        out.write(tokens.text(i));
+        out.write(COLOR_RESET);
+        sourcePos = tokens.offset(i) + tokens.length(i);
     }
-    std::cout << std::endl;
+
+    out.write(text(sourcePos, source.length()));
+    out.put('\n');
+}
+
+void Lexer::printTokens(const TokenBuffer& tokens, OutputWriter& out) {
+    printTokenArrays(tokens, out);
 }
 
+void Lexer::printColored(const TokenBuffer& tokens, OutputWriter& out) {
+    printColoredArrays(tokens, out);
+}
+
+void Lexer::printTokens(const CachedTokens& tokens, OutputWriter& out) {
+    printTokenArrays(tokens, out);
+}
+
+void Lexer::printColored(const CachedTokens& tokens, OutputWriter& out) {
+    printColoredArrays(tokens, out);
+}
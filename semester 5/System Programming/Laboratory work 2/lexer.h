@@ -1,9 +1,17 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
+#include "source_buffer.h"
+#include "line_index.h"
+
+class OutputWriter;
+class TokenBuffer;
+class CachedTokens;
 
 enum class TokenType {
     // Numbers
@@ -38,53 +46,117 @@ enum class TokenType {
     END_OF_FILE
 };
 
+// Token text is a view into the Lexer's source buffer, so tokens stay
+// valid only as long as the Lexer that produced them. When the source is
+// streamed, a token from nextToken() is valid until the next call.
+// Line and column are not stored; Lexer::locate() derives them from the
+// position when they are needed.
 struct Token {
     TokenType type;
-    std::string value;
-    size_t line;
-    size_t column;
-    size_t position;  // Character position in source string
+    std::string_view value;
+    size_t position;  // Byte offset in the source
     
-    Token(TokenType t, const std::string& v, size_t l, size_t c, size_t p = 0)
-        : type(t), value(v), line(l), column(c), position(p) {}
+    Token(TokenType t, std::string_view v, size_t p = 0)
+        : type(t), value(v), position(p) {}
+};
+
+// Upper-case name of a token type, as printed by --pairs
+const char* tokenTypeName(TokenType type);
+
+class Lexer;
+
+// Input iterator over Lexer::nextToken(). Yields every token up to and
+// including END_OF_FILE.
+class TokenIterator {
+private:
+    Lexer* lexer;
+    Token current;
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Token;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Token*;
+    using reference = const Token&;
+
+    TokenIterator() : lexer(nullptr), current(TokenType::END_OF_FILE, std::string_view()) {}
+    explicit TokenIterator(Lexer* source);
+
+    const Token& operator*() const { return current; }
+    const Token* operator->() const { return &current; }
+    TokenIterator& operator++();
+
+    bool operator==(const TokenIterator& other) const { return lexer == other.lexer; }
+    bool operator!=(const TokenIterator& other) const { return lexer != other.lexer; }
 };
 
 class Lexer {
 private:
-    std::string source;
-    size_t position;
-    size_t line;
-    size_t column;
-    std::vector<Token> tokens;
-    
-    // Helper methods
-    bool isWhitespace(char c);
-    bool isDigit(char c);
-    bool isHexDigit(char c);
-    bool isLetter(char c);
-    bool isIdentifierChar(char c);
-    char peek();
-    char advance();
-    void skipWhitespace();
+    friend class IncrementalLexer;
+
+    SourceBuffer source;
+    size_t cursor;          // Input offset where the next scan starts
+    LineIndex lines;
+    bool opened;
     
-    // Token recognition methods
-    Token scanNumber();
-    Token scanString();
-    Token scanComment();
-    Token scanPreprocessor();
-    Token scanIdentifierOrKeyword();
-    Token scanOperator();
-    Token scanDelimiter();
+    // Scanning core: skips blanks and newlines from 'from', then matches one
+    // token with the DFA in dfa.h. Sets tokenStart and type (END_OF_FILE at the
+    // end of input or at '\0') and returns the offset just past the token.
+    static size_t scanToken(const char* data, size_t length, size_t from,
+                            size_t& tokenStart, TokenType& type);
+
+    // Tokenizes from 'from' up to 'end' (or a '\0'), appends to 'out' and
+    // returns where scanning stopped
+    static size_t scanRange(const char* data, size_t from, size_t end, std::vector<Token>& out);
+
+    // Streaming: reads ahead until the next token is complete in the window
+    void bufferNextToken();
+    // Slides the window, indexing the lines of the bytes it drops first
+    bool fillWindow(size_t keepFrom);
+    void printPair(const Token& token, OutputWriter& out);
+    // Source text between two input offsets still held in the buffer
+    std::string_view text(size_t begin, size_t end) const;
+
+    template <typename Tokens>
+    void printColoredArrays(const Tokens& tokens, OutputWriter& out);
     
     // Reserved words check
-    bool isReservedWord(const std::string& word);
+    bool isReservedWord(std::string_view word);
     
 public:
     Lexer(const std::string& filename);
+
+    bool isOpen() const { return opened; }
+    // The whole source; a streamed source is read in full first
+    std::string_view contents();
+
+    // Line and column of an input offset. On a streamed source the offset
+    // must not be behind the last token returned by nextToken().
+    SourceLocation locate(size_t position);
+
+    // Pull interface: returns tokens one at a time, then END_OF_FILE forever.
+    // Works in constant memory, including on streamed input.
+    Token nextToken();
+    TokenIterator begin() { return TokenIterator(this); }
+    TokenIterator end() { return TokenIterator(); }
+
+    // Whole-file interface: lexes from the start and returns every token.
+    // A streamed source is read in full first, so call these before nextToken().
     std::vector<Token> tokenize();
-    void printTokens();
-    void printColored();
+    std::vector<Token> tokenizeParallel(size_t threadCount = 0);
+    // Same tokens in struct-of-arrays form (see token_buffer.h)
+    TokenBuffer tokenizeCompact();
+
+    // Print the remaining tokens as they are pulled from nextToken()
+    void printTokens(OutputWriter& out);
+    void printColored(OutputWriter& out);
+    // Print an already tokenized file; tokens must be in source order
+    void printTokens(const std::vector<Token>& tokens, OutputWriter& out);
+    void printColored(const std::vector<Token>& tokens, OutputWriter& out);
+    void printTokens(const TokenBuffer& tokens, OutputWriter& out);
+    void printColored(const TokenBuffer& tokens, OutputWriter& out);
+    void printTokens(const CachedTokens& tokens, OutputWriter& out);
+    void printColored(const CachedTokens& tokens, OutputWriter& out);
 };
 
 #endif // LEXER_H
-
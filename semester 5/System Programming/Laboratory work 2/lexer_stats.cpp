@@ -0,0 +1,136 @@
+#include "lexer_stats.h"
+
+#ifdef LEXER_STATS
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace stats {
+
+namespace {
+
+struct ThreadCounters;
+
+// Threads that are still running, and the totals of those that are gone
+std::mutex registryMutex;
+std::vector<ThreadCounters*> liveThreads;
+Counter retired[COUNTER_COUNT];
+
+struct ThreadCounters {
+    Counter counters[COUNTER_COUNT];
+
+    ThreadCounters() : counters() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        liveThreads.push_back(this);
+    }
+
+    ~ThreadCounters() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (size_t i = 0; i < COUNTER_COUNT; i++) {
+            retired[i].calls += counters[i].calls;
+            retired[i].bytes += counters[i].bytes;
+            retired[i].ticks += counters[i].ticks;
+        }
+        liveThreads.erase(std::find(liveThreads.begin(), liveThreads.end(), this));
+    }
+};
+
+thread_local ThreadCounters local;
+
+const char* counterName(size_t counter) {
+    if (counter == BLANKS) {
+        return "blanks and newlines";
+    }
+    if (counter == RESERVED_LOOKUP) {
+        return "  reserved word lookup";
+    }
+    return tokenTypeName(static_cast<TokenType>(counter));
+}
+
+} // namespace
+
+void record(size_t counter, size_t bytes, uint64_t startedAt) {
+    Counter& c = local.counters[counter];
+    c.calls++;
+    c.bytes += bytes;
+    c.ticks += now() - startedAt;
+}
+
+void snapshot(Counter (&out)[COUNTER_COUNT]) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        out[i] = retired[i];
+        for (const ThreadCounters* thread : liveThreads) {
+            out[i].calls += thread->counters[i].calls;
+            out[i].bytes += thread->counters[i].bytes;
+            out[i].ticks += thread->counters[i].ticks;
+        }
+    }
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        retired[i] = Counter();
+        for (ThreadCounters* thread : liveThreads) {
+            thread->counters[i] = Counter();
+        }
+    }
+}
+
+void printTable(std::ostream& out) {
+    Counter counters[COUNTER_COUNT];
+    snapshot(counters);
+
+    // The lookup row is part of the identifier rows, so it is not added again
+    Counter total = Counter();
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        if (i != RESERVED_LOOKUP) {
+            total.calls += counters[i].calls;
+            total.bytes += counters[i].bytes;
+            total.ticks += counters[i].ticks;
+        }
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %12s %12s %14s %10s %7s",
+                  "Scanner", "Calls", "Bytes", TICK_UNIT, "per byte", "Share");
+    out << line << '\n';
+
+    auto printRow = [&](const char* name, const Counter& c) {
+        double perByte = c.bytes ? static_cast<double>(c.ticks) / c.bytes : 0.0;
+        double share = total.ticks ? 100.0 * c.ticks / total.ticks : 0.0;
+        std::snprintf(line, sizeof(line), "%-24s %12llu %12llu %14llu %10.2f %6.1f%%", name,
+                      static_cast<unsigned long long>(c.calls), static_cast<unsigned long long>(c.bytes),
+                      static_cast<unsigned long long>(c.ticks), perByte, share);
+        out << line << '\n';
+    };
+
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        if (counters[i].calls > 0) {
+            printRow(counterName(i), counters[i]);
+        }
+    }
+    printRow("Total", total);
+    out.flush();
+}
+
+void printJson(std::ostream& out) {
+    Counter counters[COUNTER_COUNT];
+    snapshot(counters);
+
+    out << "{\"unit\": \"" << TICK_UNIT << "\", \"scanners\": [";
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        const char* name = i == BLANKS ? "BLANKS" : i == RESERVED_LOOKUP ? "RESERVED_LOOKUP"
+                                                                          : counterName(i);
+        out << (i == 0 ? "" : ", ") << "{\"name\": \"" << name << "\", \"calls\": " << counters[i].calls
+            << ", \"bytes\": " << counters[i].bytes << ", \"" << TICK_UNIT << "\": " << counters[i].ticks << "}";
+    }
+    out << "]}" << std::endl;
+}
+
+} // namespace stats
+
+#endif // LEXER_STATS
@@ -0,0 +1,69 @@
+#ifndef LEXER_STATS_H
+#define LEXER_STATS_H
+
+// Optional scanner instrumentation, compiled in with -DLEXER_STATS
+// (make STATS=1). For every token class the scanner records how many tokens
+// it produced, how many bytes they covered and how long scanning them took,
+// read from the time-stamp counter on x86 and steady_clock elsewhere.
+// Without LEXER_STATS the hooks below expand to nothing.
+
+#ifdef LEXER_STATS
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "lexer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace stats {
+
+// One counter per token class, then the two that are not tokens
+const size_t BLANKS = static_cast<size_t>(TokenType::END_OF_FILE);
+const size_t RESERVED_LOOKUP = BLANKS + 1;   // Nested inside IDENTIFIER and RESERVED_WORD
+const size_t COUNTER_COUNT = RESERVED_LOOKUP + 1;
+
+struct Counter {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t ticks;
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+const char* const TICK_UNIT = "cycles";
+inline uint64_t now() { return __rdtsc(); }
+#else
+const char* const TICK_UNIT = "ns";
+inline uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+// Counters live per thread, so recording takes no lock
+void record(size_t counter, size_t bytes, uint64_t startedAt);
+
+// Sums over every thread that has recorded so far
+void snapshot(Counter (&out)[COUNTER_COUNT]);
+void reset();
+
+void printTable(std::ostream& out);
+void printJson(std::ostream& out);
+
+} // namespace stats
+
+#define LEXER_STATS_START(name) const uint64_t name = stats::now()
+#define LEXER_STATS_RECORD(counter, bytes, startedAt) stats::record((counter), (bytes), (startedAt))
+
+#else
+
+#define LEXER_STATS_START(name) ((void)0)
+#define LEXER_STATS_RECORD(counter, bytes, startedAt) ((void)0)
+
+#endif // LEXER_STATS
+
+#endif // LEXER_STATS_H
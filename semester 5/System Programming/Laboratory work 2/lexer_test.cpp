@@ -0,0 +1,315 @@
+#include "keywords.h"
+#include "lexer.h"
+#include "output_writer.h"
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+// Differential test of the DFA scanner in lexer.cpp against the hand-written
+// scanner it replaced. Both token streams are printed through the same
+// --pairs and --colored code, and any difference in the output fails.
+
+// Reference implementation: the original character-at-a-time scanner, with
+// its <cctype> tests and if/else dispatch, kept as it was apart from dropping
+// the line and column bookkeeping that Token no longer carries.
+class ReferenceScanner {
+private:
+    std::string_view source;
+    size_t position;
+
+    static bool isWhitespace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+    static bool isDigit(char c) { return std::isdigit(static_cast<unsigned char>(c)); }
+    static bool isHexDigit(char c) { return std::isxdigit(static_cast<unsigned char>(c)); }
+    static bool isLetter(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+    static bool isIdentifierChar(char c) { return isLetter(c) || isDigit(c) || c == '_'; }
+
+    std::string_view lexeme(size_t start) const { return source.substr(start, position - start); }
+
+    char peek() const { return position < source.length() ? source[position] : '\0'; }
+    void advance() {
+        if (position < source.length()) {
+            position++;
+        }
+    }
+
+    void skipWhitespace() {
+        while (position < source.length() && isWhitespace(source[position])) {
+            advance();
+        }
+    }
+
+    bool atRem() const {
+        return position + 2 < source.length() &&
+               (source[position] == 'R' || source[position] == 'r') &&
+               (source[position + 1] == 'E' || source[position + 1] == 'e') &&
+               (source[position + 2] == 'M' || source[position + 2] == 'm') &&
+               (position + 3 >= source.length() || isWhitespace(source[position + 3]) ||
+                source[position + 3] == '\n');
+    }
+
+    Token scanNumber() {
+        size_t start = position;
+
+        if (peek() == '&' && position + 1 < source.length()) {
+            char next = source[position + 1];
+            if (next == 'H' || next == 'h') {
+                advance();
+                advance();
+                while (position < source.length() && isHexDigit(peek())) {
+                    advance();
+                }
+                if (peek() == '&' || peek() == '!' || peek() == '#') {
+                    advance();
+                }
+                return Token(TokenType::HEXADECIMAL, lexeme(start), start);
+            }
+        }
+
+        while (position < source.length() && isDigit(peek())) {
+            advance();
+        }
+
+        if (peek() == '.' && position + 1 < source.length() && isDigit(source[position + 1])) {
+            advance();
+            while (position < source.length() && isDigit(peek())) {
+                advance();
+            }
+            if (peek() == 'E' || peek() == 'e') {
+                advance();
+                if (peek() == '+' || peek() == '-') {
+                    advance();
+                }
+                while (position < source.length() && isDigit(peek())) {
+                    advance();
+                }
+            }
+            if (peek() == '!' || peek() == '#' || peek() == '@') {
+                advance();
+            }
+            return Token(TokenType::FLOATING_POINT, lexeme(start), start);
+        }
+
+        if (peek() == '&' || peek() == '!' || peek() == '#' || peek() == '@' || peek() == '%') {
+            advance();
+        }
+        return Token(TokenType::DECIMAL_INTEGER, lexeme(start), start);
+    }
+
+    Token scanString() {
+        size_t start = position;
+        char quote = peek();
+        advance();
+
+        bool isChar = false;
+        while (position < source.length()) {
+            char c = peek();
+            if (c == '\0' || c == '\n') {
+                break;
+            }
+            if (c == quote) {
+                advance();
+                if (peek() == 'C' || peek() == 'c') {
+                    advance();
+                    isChar = true;
+                }
+                break;
+            }
+            advance();
+            if (c == '\\' && position < source.length()) {
+                advance();
+            }
+        }
+
+        return Token(isChar ? TokenType::CHARACTER_CONSTANT : TokenType::STRING_CONSTANT, lexeme(start), start);
+    }
+
+    Token scanComment() {
+        size_t start = position;
+        if (atRem()) {
+            advance();
+            advance();
+            advance();
+            skipWhitespace();
+        } else if (peek() == '\'') {
+            advance();
+        }
+        while (position < source.length() && peek() != '\n' && peek() != '\0') {
+            advance();
+        }
+        return Token(TokenType::COMMENT, lexeme(start), start);
+    }
+
+    Token scanPreprocessor() {
+        size_t start = position;
+        advance();
+        while (position < source.length() && isLetter(peek())) {
+            advance();
+        }
+        while (position < source.length() && peek() != '\n' && peek() != '\0') {
+            advance();
+        }
+        return Token(TokenType::PREPROCESSOR_DIRECTIVE, lexeme(start), start);
+    }
+
+    Token scanIdentifierOrKeyword() {
+        size_t start = position;
+        while (position < source.length() && isIdentifierChar(peek())) {
+            advance();
+        }
+        std::string_view value = lexeme(start);
+        return Token(keywords::isReservedWord(value) ? TokenType::RESERVED_WORD : TokenType::IDENTIFIER,
+                     value, start);
+    }
+
+    Token scanOperator() {
+        size_t start = position;
+        char c = peek();
+        advance();
+        if ((c == '<' && (peek() == '=' || peek() == '>')) || ((c == '>' || c == '/') && peek() == '=')) {
+            advance();
+        }
+        return Token(TokenType::OPERATOR, lexeme(start), start);
+    }
+
+public:
+    explicit ReferenceScanner(std::string_view text) : source(text), position(0) {}
+
+    std::vector<Token> tokenize() {
+        std::vector<Token> tokens;
+        while (position < source.length()) {
+            skipWhitespace();
+            if (position >= source.length()) {
+                break;
+            }
+
+            char c = peek();
+            if (c == '\0') {
+                break;
+            }
+            if (c == '\n') {
+                advance();
+                continue;
+            }
+
+            if (isDigit(c) || (c == '&' && position + 1 < source.length() &&
+                               (source[position + 1] == 'H' || source[position + 1] == 'h'))) {
+                tokens.push_back(scanNumber());
+            } else if (c == '"') {
+                tokens.push_back(scanString());
+            } else if (c == '\'' || atRem()) {
+                tokens.push_back(scanComment());
+            } else if (c == '#') {
+                tokens.push_back(scanPreprocessor());
+            } else if (isLetter(c)) {
+                tokens.push_back(scanIdentifierOrKeyword());
+            } else if (c == '<' || c == '>' || c == '=' || c == '+' || c == '-' ||
+                       c == '*' || c == '/' || c == '\\' || c == '^' || c == '&') {
+                tokens.push_back(scanOperator());
+            } else if (c == '(' || c == ')' || c == '[' || c == ']' || c == '{' ||
+                       c == '}' || c == ',' || c == ';' || c == ':' || c == '.') {
+                size_t start = position;
+                advance();
+                tokens.push_back(Token(TokenType::DELIMITER, lexeme(start), start));
+            } else {
+                size_t start = position;
+                advance();
+                tokens.push_back(Token(TokenType::UNRECOGNIZED, lexeme(start), start));
+            }
+        }
+
+        tokens.push_back(Token(TokenType::END_OF_FILE, std::string_view(), position));
+        return tokens;
+    }
+};
+
+// Prints tokens of the lexer's file with --pairs or --colored and returns
+// the text, going through a temporary file since OutputWriter writes to one
+static bool render(Lexer& lexer, const std::vector<Token>& tokens, bool pairs, std::string& text) {
+    char path[] = "/tmp/lexer_test_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+
+    bool ok;
+    {
+        OutputWriter out;
+        ok = out.open(path);
+        if (ok) {
+            if (pairs) {
+                lexer.printTokens(tokens, out);
+            } else {
+                lexer.printColored(tokens, out);
+            }
+            out.flush();
+            ok = !out.hasFailed();
+        }
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    text = contents.str();
+    unlink(path);
+    return ok;
+}
+
+// 1-based number of the first line where a and b differ
+static size_t firstDifferentLine(const std::string& a, const std::string& b) {
+    size_t line = 1;
+    for (size_t i = 0; i < a.size() && i < b.size() && a[i] == b[i]; i++) {
+        if (a[i] == '\n') {
+            line++;
+        }
+    }
+    return line;
+}
+
+static bool testFile(const std::string& filename) {
+    Lexer lexer(filename);
+    if (!lexer.isOpen()) {
+        return false;
+    }
+
+    std::vector<Token> expected = ReferenceScanner(lexer.contents()).tokenize();
+    std::vector<Token> actual = lexer.tokenize();
+
+    bool passed = true;
+    for (bool pairs : {true, false}) {
+        const char* mode = pairs ? "--pairs" : "--colored";
+        std::string expectedText, actualText;
+        if (!render(lexer, expected, pairs, expectedText) || !render(lexer, actual, pairs, actualText)) {
+            std::cerr << filename << " " << mode << ": cannot write the output" << std::endl;
+            return false;
+        }
+
+        if (expectedText == actualText) {
+            std::cout << "PASS " << filename << " " << mode << std::endl;
+        } else {
+            std::cout << "FAIL " << filename << " " << mode << ": output differs from line "
+                      << firstDifferentLine(expectedText, actualText) << std::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file>..." << std::endl;
+        return 1;
+    }
+
+    bool passed = true;
+    for (int i = 1; i < argc; i++) {
+        passed = testFile(argv[i]) && passed;
+    }
+    return passed ? 0 : 1;
+}
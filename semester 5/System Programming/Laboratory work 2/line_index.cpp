@@ -0,0 +1,39 @@
+#include "line_index.h"
+#include "simd_scan.h"
+#include <algorithm>
+
+LineIndex::LineIndex() : starts(1, 0), firstLine(1), indexedEnd(0) {}
+
+void LineIndex::extend(const char* data, size_t base, size_t end) {
+    if (end <= indexedEnd) {
+        return;
+    }
+    simd::appendLineStarts(data, indexedEnd - base, end - base, base, starts);
+    indexedEnd = end;
+}
+
+void LineIndex::discardBefore(size_t offset) {
+    // Keep the line that holds 'offset'
+    auto holder = std::upper_bound(starts.begin(), starts.end(), offset) - 1;
+    size_t dropped = holder - starts.begin();
+    if (dropped > 0) {
+        starts.erase(starts.begin(), holder);
+        firstLine += dropped;
+    }
+}
+
+void LineIndex::truncate(size_t offset) {
+    if (offset >= indexedEnd) {
+        return;
+    }
+    // A line starting at offset + 1 or later may no longer exist
+    auto kept = std::upper_bound(starts.begin() + 1, starts.end(), offset);
+    starts.erase(kept, starts.end());
+    indexedEnd = offset;
+}
+
+SourceLocation LineIndex::locate(size_t offset) const {
+    auto after = std::upper_bound(starts.begin(), starts.end(), offset);
+    size_t index = after - starts.begin() - 1;
+    return SourceLocation{firstLine + index, offset - starts[index] + 1};
+}
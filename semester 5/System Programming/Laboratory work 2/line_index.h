@@ -0,0 +1,45 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <cstddef>
+#include <vector>
+
+// 1-based line and column of a byte offset
+struct SourceLocation {
+    size_t line;
+    size_t column;
+};
+
+// Offsets where lines begin, so a byte offset maps to its line and column
+// by binary search instead of the scanner counting lines as it goes.
+// The index is built front to back as far as it is needed. A streamed
+// source can drop lines it has moved past, keeping memory bounded by the
+// lines still in its window.
+class LineIndex {
+private:
+    std::vector<size_t> starts;   // Ascending; starts[0] begins line firstLine
+    size_t firstLine;
+    size_t indexedEnd;            // Every '\n' before this offset is recorded
+
+public:
+    LineIndex();
+
+    // Records the lines starting in [indexedTo(), end). data[0] is the byte
+    // at input offset 'base', and the range must lie inside it.
+    void extend(const char* data, size_t base, size_t end);
+    // Forgets the lines that end at or before 'offset'
+    void discardBefore(size_t offset);
+    // Forgets everything from 'offset' on, for sources edited in place
+    void truncate(size_t offset);
+
+    size_t indexedTo() const { return indexedEnd; }
+    size_t lineCount() const { return starts.size(); }
+    size_t lineStart(size_t index) const { return starts[index]; }
+
+    // 'offset' must lie between the first kept line and indexedTo()
+    SourceLocation locate(size_t offset) const;
+
+    size_t memoryUsage() const { return starts.capacity() * sizeof(size_t); }
+};
+
+#endif // LINE_INDEX_H
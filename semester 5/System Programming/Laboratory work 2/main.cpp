@@ -1,37 +1,152 @@
 #include "lexer.h"
+#include "batch.h"
+#include "output_writer.h"
+#include "token_buffer.h"
+#include "token_cache.h"
+#include "lexer_stats.h"
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
+
+// --batch <file|dir|glob>... [--threads N] [-o <output>]
+static int runBatch(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    size_t threadCount = 0;
+    std::string outputFile;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threadCount = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    OutputWriter out;
+    if (!outputFile.empty() && !out.open(outputFile)) {
+        std::cerr << "Error: Cannot write file " << outputFile << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> files = batch::collectSources(inputs);
+    std::vector<batch::FileResult> results = batch::lexFiles(files, threadCount);
+    auto end = std::chrono::steady_clock::now();
+
+    batch::printReport(results, std::chrono::duration<double>(end - start).count(), out);
+    out.flush();
+    return out.hasFailed() ? 1 : 0;
+}
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename> [--pairs|--colored]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <filename|-> [--pairs|--colored] [--parallel] [-o <output>] [--cache <dir>] [--stats|--stats-json]" << std::endl;
+        std::cerr << "  -          : Read the source from stdin" << std::endl;
         std::cerr << "  --pairs    : Output token pairs <lexeme, token_type>" << std::endl;
         std::cerr << "  --colored  : Output colored syntax highlighting (default)" << std::endl;
+        std::cerr << "  --parallel : Tokenize large files on all hardware threads" << std::endl;
+        std::cerr << "  -o <file>  : Write the output to a file instead of stdout" << std::endl;
+        std::cerr << "  --cache <dir> : Reuse token streams cached in <dir> for unchanged files" << std::endl;
+        std::cerr << "  --stats    : Print per-scanner counts and timings to stderr (build with make STATS=1)" << std::endl;
+        std::cerr << "  --stats-json : Same as --stats, as JSON" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch <file|dir|glob>... [--threads N] [-o <output>]" << std::endl;
+        std::cerr << "  --batch    : Lex many files on a thread pool and print statistics" << std::endl;
+        std::cerr << "  --threads  : Worker threads for --batch (default: all hardware threads)" << std::endl;
         return 1;
     }
 
+    if (std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+
     std::string filename = argv[1];
     bool outputPairs = false;
+    bool parallel = false;
+    std::string outputFile;
+    std::string cacheDir;
+    bool printStats = false;
+    bool statsJson = false;
 
-    // Check for output mode
-    if (argc >= 3) {
-        std::string mode = argv[2];
+    // Check for output mode and options
+    for (int i = 2; i < argc; i++) {
+        std::string mode = argv[i];
         if (mode == "--pairs") {
             outputPairs = true;
         } else if (mode == "--colored") {
             outputPairs = false;
+        } else if (mode == "--parallel") {
+            parallel = true;
+        } else if (mode == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (mode == "--cache" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (mode == "--stats") {
+            printStats = true;
+        } else if (mode == "--stats-json") {
+            printStats = true;
+            statsJson = true;
         }
     }
 
+    OutputWriter out;
+    if (!outputFile.empty() && !out.open(outputFile)) {
+        std::cerr << "Error: Cannot write file " << outputFile << std::endl;
+        return 1;
+    }
+
     Lexer lexer(filename);
-    std::vector<Token> tokens = lexer.tokenize();
 
-    if (outputPairs) {
-        lexer.printTokens();
+    if (!cacheDir.empty()) {
+        // Reuse the token stream from an earlier run on the same contents
+        TokenCache cache(cacheDir);
+        CachedTokens cached;
+        if (cache.load(lexer.contents(), cached)) {
+            if (outputPairs) {
+                lexer.printTokens(cached, out);
+            } else {
+                lexer.printColored(cached, out);
+            }
+        } else {
+            TokenBuffer tokens = lexer.tokenizeCompact();
+            cache.store(lexer.contents(), tokens);
+            if (outputPairs) {
+                lexer.printTokens(tokens, out);
+            } else {
+                lexer.printColored(tokens, out);
+            }
+        }
+    } else if (parallel) {
+        std::vector<Token> tokens = lexer.tokenizeParallel();
+        if (outputPairs) {
+            lexer.printTokens(tokens, out);
+        } else {
+            lexer.printColored(tokens, out);
+        }
+    } else if (outputPairs) {
+        lexer.printTokens(out);
     } else {
-        lexer.printColored();
+        lexer.printColored(out);
     }
 
-    return 0;
+    out.flush();
+
+    if (printStats) {
+#ifdef LEXER_STATS
+        if (statsJson) {
+            stats::printJson(std::cerr);
+        } else {
+            stats::printTable(std::cerr);
+        }
+#else
+        (void)statsJson;
+        std::cerr << "Note: scanner statistics are not compiled in; rebuild with make clean && make STATS=1" << std::endl;
+#endif
+    }
+    return out.hasFailed() ? 1 : 0;
 }
 
@@ -0,0 +1,79 @@
+#include "output_writer.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+OutputWriter::OutputWriter() : used(0), fd(STDOUT_FILENO), ownsFd(false), failed(false) {}
+
+OutputWriter::~OutputWriter() {
+    flush();
+    if (ownsFd) {
+        close(fd);
+    }
+}
+
+bool OutputWriter::open(const std::string& filename) {
+    int file = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+
+    flush();
+    if (ownsFd) {
+        close(fd);
+    }
+    fd = file;
+    ownsFd = true;
+    return true;
+}
+
+void OutputWriter::writeAll(const char* data, size_t length) {
+    while (length > 0 && !failed) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+}
+
+void OutputWriter::flush() {
+    if (used > 0) {
+        writeAll(buffer, used);
+        used = 0;
+    }
+}
+
+void OutputWriter::writeLarge(std::string_view text) {
+    // Top up the current block first so blocks stay full
+    size_t room = BLOCK_SIZE - used;
+    text.copy(buffer + used, room);
+    used = BLOCK_SIZE;
+    text.remove_prefix(room);
+    flush();
+
+    if (text.size() >= BLOCK_SIZE) {
+        writeAll(text.data(), text.size());
+    } else {
+        text.copy(buffer, text.size());
+        used = text.size();
+    }
+}
+
+void OutputWriter::writeNumber(size_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0) {
+        put(digits[--count]);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Buffered output to a file descriptor.
+// Text is collected in a fixed block and handed to the kernel with a single
+// write(2) once the block is full, so printing never flushes per token.
+// Strings larger than a block bypass the buffer.
+class OutputWriter {
+private:
+    static const size_t BLOCK_SIZE = 1 << 16;
+
+    char buffer[BLOCK_SIZE];
+    size_t used;
+    int fd;
+    bool ownsFd;
+    bool failed;
+
+    void writeAll(const char* data, size_t length);
+    void writeLarge(std::string_view text);
+
+public:
+    // Writes to standard output
+    OutputWriter();
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    // Redirects output to a file, truncating it
+    bool open(const std::string& filename);
+
+    void write(std::string_view text) {
+        if (text.size() > BLOCK_SIZE - used) {
+            writeLarge(text);
+            return;
+        }
+        text.copy(buffer + used, text.size());
+        used += text.size();
+    }
+    void put(char c) {
+        if (used == BLOCK_SIZE) {
+            flush();
+        }
+        buffer[used++] = c;
+    }
+    void writeNumber(size_t value);
+
+    // Hands the buffered text to the kernel
+    void flush();
+
+    // True if any write(2) failed
+    bool hasFailed() const { return failed; }
+};
+
+#endif // OUTPUT_WRITER_H
@@ -0,0 +1,131 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Vectorized searches for the long runs the lexer sees most: blanks, comment
+// and directive text up to the end of the line, and string bodies. Each
+// function returns the offset of the first byte in [pos, length) that ends
+// the run, or length. AVX2 is used when the compiler targets it (for example
+// with -mavx2), SSE2 otherwise on x86-64, and a scalar loop everywhere else
+// and for the tail of every buffer.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIMD_SCAN_VECTOR 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_SCAN_VECTOR 1
+#endif
+
+namespace simd {
+
+#if defined(__AVX2__)
+using Vec = __m256i;
+constexpr size_t WIDTH = 32;
+
+inline Vec load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline Vec equals(Vec v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+inline Vec either(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline uint32_t bits(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+inline uint32_t allBits() { return 0xFFFFFFFFu; }
+#elif defined(__SSE2__)
+using Vec = __m128i;
+constexpr size_t WIDTH = 16;
+
+inline Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline Vec equals(Vec v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+inline Vec either(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline uint32_t bits(Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+inline uint32_t allBits() { return 0xFFFFu; }
+#endif
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// First byte that is not ' ', '\t' or '\r'
+inline size_t skipBlanks(const char* data, size_t pos, size_t length) {
+#ifdef SIMD_SCAN_VECTOR
+    while (pos + WIDTH <= length) {
+        Vec v = load(data + pos);
+        uint32_t blank = bits(either(either(equals(v, ' '), equals(v, '\t')), equals(v, '\r')));
+        uint32_t stop = ~blank & allBits();
+        if (stop) {
+            return pos + __builtin_ctz(stop);
+        }
+        pos += WIDTH;
+    }
+#endif
+    while (pos < length && isBlank(data[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+// First '\n' or '\0'
+inline size_t findLineEnd(const char* data, size_t pos, size_t length) {
+#ifdef SIMD_SCAN_VECTOR
+    while (pos + WIDTH <= length) {
+        Vec v = load(data + pos);
+        uint32_t stop = bits(either(equals(v, '\n'), equals(v, '\0')));
+        if (stop) {
+            return pos + __builtin_ctz(stop);
+        }
+        pos += WIDTH;
+    }
+#endif
+    while (pos < length && data[pos] != '\n' && data[pos] != '\0') {
+        pos++;
+    }
+    return pos;
+}
+
+// First byte that ends a plain run of string body: '"', '\\', '\n' or '\0'
+inline size_t findStringStop(const char* data, size_t pos, size_t length) {
+#ifdef SIMD_SCAN_VECTOR
+    while (pos + WIDTH <= length) {
+        Vec v = load(data + pos);
+        uint32_t stop = bits(either(either(equals(v, '"'), equals(v, '\\')),
+                                    either(equals(v, '\n'), equals(v, '\0'))));
+        if (stop) {
+            return pos + __builtin_ctz(stop);
+        }
+        pos += WIDTH;
+    }
+#endif
+    while (pos < length) {
+        char c = data[pos];
+        if (c == '"' || c == '\\' || c == '\n' || c == '\0') {
+            break;
+        }
+        pos++;
+    }
+    return pos;
+}
+
+// Appends base + i + 1 for every '\n' at data[i], i in [pos, end): the
+// offsets where the following lines start
+inline void appendLineStarts(const char* data, size_t pos, size_t end, size_t base,
+                             std::vector<size_t>& out) {
+#ifdef SIMD_SCAN_VECTOR
+    while (pos + WIDTH <= end) {
+        uint32_t found = bits(equals(load(data + pos), '\n'));
+        while (found) {
+            out.push_back(base + pos + __builtin_ctz(found) + 1);
+            found &= found - 1;
+        }
+        pos += WIDTH;
+    }
+#endif
+    for (; pos < end; pos++) {
+        if (data[pos] == '\n') {
+            out.push_back(base + pos + 1);
+        }
+    }
+}
+
+} // namespace simd
+
+#endif // SIMD_SCAN_H
@@ -0,0 +1,126 @@
+#include "source_buffer.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Block size used when the input has to be read instead of mapped
+static const size_t READ_BLOCK_SIZE = 1 << 16;
+
+SourceBuffer::SourceBuffer()
+    : bytes(""), byteCount(0), windowBase(0), mapping(nullptr), mappingLength(0), streamFd(-1) {}
+
+SourceBuffer::~SourceBuffer() {
+    release();
+}
+
+void SourceBuffer::closeStream() {
+    if (streamFd > STDIN_FILENO) {
+        close(streamFd);
+    }
+    streamFd = -1;
+}
+
+void SourceBuffer::release() {
+    if (mapping) {
+        munmap(mapping, mappingLength);
+        mapping = nullptr;
+        mappingLength = 0;
+    }
+    closeStream();
+    window.clear();
+    window.shrink_to_fit();
+    bytes = "";
+    byteCount = 0;
+    windowBase = 0;
+}
+
+bool SourceBuffer::open(const std::string& filename) {
+    release();
+
+    int fd = filename == "-" ? STDIN_FILENO : ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+        return false;
+    }
+
+    streamFd = fd;
+    if (!S_ISREG(info.st_mode)) {
+        // Streamed: the window is filled on demand
+        return true;
+    }
+
+    // Regular files are mapped read-only; empty files cannot be mapped
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        closeStream();
+        return true;
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        // Fall back to a plain read if the filesystem refuses mmap
+        window.reserve(size);
+        loadAll();
+        return true;
+    }
+
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    closeStream();
+    mapping = mapped;
+    mappingLength = size;
+    bytes = static_cast<const char*>(mapped);
+    byteCount = size;
+    return true;
+}
+
+bool SourceBuffer::readBlock() {
+    size_t used = window.size();
+    window.resize(used + READ_BLOCK_SIZE);
+
+    ssize_t n;
+    do {
+        n = read(streamFd, &window[used], READ_BLOCK_SIZE);
+    } while (n < 0 && errno == EINTR);
+
+    window.resize(used + (n > 0 ? static_cast<size_t>(n) : 0));
+    bytes = window.data();
+    byteCount = window.size();
+
+    if (n <= 0) {
+        // End of input, or a read error that ends it just the same
+        closeStream();
+        return false;
+    }
+    return true;
+}
+
+bool SourceBuffer::fill(size_t keepFrom) {
+    if (exhausted()) {
+        return false;
+    }
+
+    if (keepFrom > windowBase) {
+        size_t drop = keepFrom - windowBase;
+        if (drop > window.size()) {
+            drop = window.size();
+        }
+        window.erase(0, drop);
+        windowBase += drop;
+    }
+    return readBlock();
+}
+
+void SourceBuffer::loadAll() {
+    while (!exhausted()) {
+        readBlock();
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <string>
+#include <cstddef>
+
+// Read-only view of a source file.
+// Regular files are memory-mapped so the lexer scans the page cache directly.
+// Pipes, stdin ("-") and other non-seekable inputs are streamed instead: the
+// buffer then holds a sliding window of the input, which fill() advances
+// block by block, so memory stays bounded by the longest line.
+class SourceBuffer {
+private:
+    const char* bytes;
+    size_t byteCount;
+    size_t windowBase;      // Input offset of bytes[0]
+    void* mapping;          // Non-null when the file is memory-mapped
+    size_t mappingLength;
+    std::string window;     // Owns the bytes when the input is not mapped
+    int streamFd;           // Open while more input may follow the window
+
+    void release();
+    void closeStream();
+    bool readBlock();
+
+public:
+    SourceBuffer();
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    bool open(const std::string& filename);
+
+    // Bytes currently held; data()[0] is at input offset base()
+    const char* data() const { return bytes; }
+    size_t length() const { return byteCount; }
+    size_t base() const { return windowBase; }
+
+    bool isMapped() const { return mapping != nullptr; }
+    // True once the window reaches the end of the input
+    bool exhausted() const { return streamFd < 0; }
+
+    // Drops the bytes before input offset keepFrom and appends the next block.
+    // Returns false when there was nothing left to read.
+    bool fill(size_t keepFrom);
+    // Reads the rest of the input into the window without dropping anything
+    void loadAll();
+
+    char operator[](size_t index) const { return bytes[index]; }
+};
+
+#endif // SOURCE_BUFFER_H
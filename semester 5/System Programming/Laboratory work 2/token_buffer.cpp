@@ -0,0 +1,24 @@
+#include "token_buffer.h"
+
+TokenBuffer::TokenBuffer(const char* data) : source(data) {}
+
+void TokenBuffer::reserve(size_t count) {
+    kinds.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+}
+
+void TokenBuffer::indexLines(size_t end) {
+    lines = LineIndex();
+    lines.extend(source, 0, end);
+}
+
+Token TokenBuffer::at(size_t index) const {
+    std::string_view value = type(index) == TokenType::END_OF_FILE ? std::string_view() : text(index);
+    return Token(type(index), value, offsets[index]);
+}
+
+size_t TokenBuffer::memoryUsage() const {
+    return kinds.capacity() * sizeof(uint8_t) + offsets.capacity() * sizeof(uint32_t) +
+           lengths.capacity() * sizeof(uint32_t) + lines.memoryUsage();
+}
@@ -0,0 +1,57 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+#include "line_index.h"
+
+// Struct-of-arrays token storage: a byte of kind plus a 32-bit offset and
+// length per token, about 9 bytes against sizeof(Token). Line and column are
+// not stored; they come from a LineIndex when asked for, so passes
+// that only look at kinds or text scan a few dense arrays.
+// Offsets are 32-bit, so the source must be under 4 GB.
+class TokenBuffer {
+private:
+    const char* source;
+    std::vector<uint8_t> kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    LineIndex lines;
+
+public:
+    explicit TokenBuffer(const char* data = nullptr);
+
+    void reserve(size_t count);
+    void push(TokenType type, size_t offset, size_t length) {
+        kinds.push_back(static_cast<uint8_t>(type));
+        offsets.push_back(static_cast<uint32_t>(offset));
+        lengths.push_back(static_cast<uint32_t>(length));
+    }
+    // Records where lines start in source[0, end)
+    void indexLines(size_t end);
+
+    size_t size() const { return kinds.size(); }
+    TokenType type(size_t index) const { return static_cast<TokenType>(kinds[index]); }
+    size_t offset(size_t index) const { return offsets[index]; }
+    size_t length(size_t index) const { return lengths[index]; }
+    std::string_view text(size_t index) const {
+        return std::string_view(source + offsets[index], lengths[index]);
+    }
+
+    const LineIndex& lineIndex() const { return lines; }
+
+    // 1-based, found by binary search over the line starts
+    size_t line(size_t index) const { return lines.locate(offsets[index]).line; }
+    size_t column(size_t index) const { return lines.locate(offsets[index]).column; }
+
+    // The token as the Lexer would have returned it
+    Token at(size_t index) const;
+
+    // Bytes held by the arrays, counting their spare capacity
+    size_t memoryUsage() const;
+};
+
+#endif // TOKEN_BUFFER_H
@@ -0,0 +1,245 @@
+#include "token_cache.h"
+#include "token_buffer.h"
+#include "dfa.h"
+#include "keywords.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bump when the file layout or the meaning of a token changes in a way the
+// table fingerprint below cannot see (e.g. the REM handling in scanToken)
+static const uint64_t FORMAT_VERSION = 1;
+
+static const char CACHE_MAGIC[4] = {'V', 'B', 'T', 'K'};
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t reserved;
+    uint64_t lexerVersion;
+    uint64_t contentHash;
+    uint64_t sourceLength;
+    uint64_t tokenCount;
+};
+
+static_assert(sizeof(CacheHeader) == 40, "Cache header layout must not depend on padding");
+
+static const size_t BYTES_PER_TOKEN = 3 * sizeof(uint32_t) + sizeof(uint8_t);
+
+static uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static uint64_t mix(uint64_t h, uint64_t word) {
+    h ^= rotateLeft(word * 0x87C37B91114253D5ULL, 31) * 0x4CF5AD432745937FULL;
+    return rotateLeft(h, 27) * 5 + 0x52DCE729;
+}
+
+uint64_t TokenCache::hashContent(std::string_view data) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ data.size();
+    size_t pos = 0;
+
+    // Eight bytes per step; memcpy keeps unaligned loads well defined
+    for (; pos + 8 <= data.size(); pos += 8) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + pos, 8);
+        h = mix(h, word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data.data() + pos, data.size() - pos);
+    h = mix(h, tail);
+
+    // Final avalanche so nearby inputs land far apart
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Changes whenever the scanner tables or the reserved word list change
+static uint64_t lexerVersion() {
+    static const uint64_t version = [] {
+        std::string state;
+        state.append(reinterpret_cast<const char*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION));
+        state.append(reinterpret_cast<const char*>(dfa::CHAR_CLASS.data()), sizeof(dfa::CHAR_CLASS));
+        state.append(reinterpret_cast<const char*>(dfa::TRANSITIONS.data()), sizeof(dfa::TRANSITIONS));
+        state.append(reinterpret_cast<const char*>(dfa::ACCEPT.data()), sizeof(dfa::ACCEPT));
+        for (const auto& word : keywords::RESERVED_WORDS) {
+            state.append(word);
+            state.push_back('\0');
+        }
+        return TokenCache::hashContent(state);
+    }();
+    return version;
+}
+
+CachedTokens::CachedTokens()
+    : mapping(nullptr), mappingLength(0), source(nullptr), count(0),
+      offsets(nullptr), lengths(nullptr), lines(nullptr), kinds(nullptr) {}
+
+CachedTokens::~CachedTokens() {
+    release();
+}
+
+void CachedTokens::release() {
+    if (mapping) {
+        munmap(mapping, mappingLength);
+        mapping = nullptr;
+        mappingLength = 0;
+    }
+    count = 0;
+}
+
+size_t CachedTokens::column(size_t index) const {
+    size_t start = offsets[index];
+    while (start > 0 && source[start - 1] != '\n') {
+        start--;
+    }
+    return offsets[index] - start + 1;
+}
+
+Token CachedTokens::at(size_t index) const {
+    std::string_view value = type(index) == TokenType::END_OF_FILE ? std::string_view() : text(index);
+    return Token(type(index), value, offset(index));
+}
+
+TokenCache::TokenCache(std::string dir) : directory(std::move(dir)) {}
+
+std::string TokenCache::entryPath(uint64_t contentHash) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tok", static_cast<unsigned long long>(contentHash));
+    return directory + "/" + name;
+}
+
+bool TokenCache::load(std::string_view source, CachedTokens& out) const {
+    out.release();
+
+    uint64_t contentHash = hashContent(source);
+    int fd = ::open(entryPath(contentHash).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    // Anything that does not describe exactly this source is a miss
+    const CacheHeader* header = static_cast<const CacheHeader*>(mapped);
+    if (std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header->lexerVersion != lexerVersion() || header->contentHash != contentHash ||
+        header->sourceLength != source.size() ||
+        header->tokenCount > (size - sizeof(CacheHeader)) / BYTES_PER_TOKEN ||
+        size != sizeof(CacheHeader) + header->tokenCount * BYTES_PER_TOKEN) {
+        munmap(mapped, size);
+        return false;
+    }
+
+    size_t count = header->tokenCount;
+    const char* base = static_cast<const char*>(mapped) + sizeof(CacheHeader);
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(base);
+    const uint32_t* lengths = offsets + count;
+    const uint8_t* kinds = reinterpret_cast<const uint8_t*>(lengths + 2 * count);
+
+    // A damaged entry is a miss too: every token must lie inside the source
+    // and have a known kind, so the accessors can index without checks
+    for (size_t i = 0; i < count; i++) {
+        if (offsets[i] > source.size() || lengths[i] > source.size() - offsets[i] ||
+            kinds[i] > static_cast<uint8_t>(TokenType::END_OF_FILE)) {
+            munmap(mapped, size);
+            return false;
+        }
+    }
+
+    out.mapping = mapped;
+    out.mappingLength = size;
+    out.source = source.data();
+    out.count = count;
+    out.offsets = offsets;
+    out.lengths = lengths;
+    out.lines = lengths + count;
+    out.kinds = kinds;
+    return true;
+}
+
+bool TokenCache::store(std::string_view source, const TokenBuffer& tokens) const {
+    size_t count = tokens.size();
+    if (count == 0) {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.reserved = 0;
+    header.lexerVersion = lexerVersion();
+    header.contentHash = hashContent(source);
+    header.sourceLength = source.size();
+    header.tokenCount = count;
+
+    std::vector<char> image(sizeof(CacheHeader) + count * BYTES_PER_TOKEN);
+    std::memcpy(image.data(), &header, sizeof(header));
+    uint32_t* offsets = reinterpret_cast<uint32_t*>(image.data() + sizeof(CacheHeader));
+    uint32_t* lengths = offsets + count;
+    uint32_t* lines = lengths + count;
+    uint8_t* kinds = reinterpret_cast<uint8_t*>(lines + count);
+
+    // Tokens are in source order, so lines are found by walking forward
+    const LineIndex& index = tokens.lineIndex();
+    size_t line = 1;
+    for (size_t i = 0; i < count; i++) {
+        while (line < index.lineCount() && index.lineStart(line) <= tokens.offset(i)) {
+            line++;
+        }
+        offsets[i] = static_cast<uint32_t>(tokens.offset(i));
+        lengths[i] = static_cast<uint32_t>(tokens.length(i));
+        lines[i] = static_cast<uint32_t>(line);
+        kinds[i] = static_cast<uint8_t>(tokens.type(i));
+    }
+
+    // Write a private file and rename it over the entry, so readers never
+    // see a half-written stream
+    std::string path = entryPath(header.contentHash);
+    mkdir(directory.c_str(), 0755);   // Fails harmlessly if it already exists
+    std::string temporary = path + ".XXXXXX";
+    int fd = mkstemp(&temporary[0]);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t done = 0;
+    while (done < image.size()) {
+        ssize_t n = write(fd, image.data() + done, image.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            close(fd);
+            unlink(temporary.c_str());
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    fchmod(fd, 0644);
+    close(fd);
+
+    if (rename(temporary.c_str(), path.c_str()) != 0) {
+        unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
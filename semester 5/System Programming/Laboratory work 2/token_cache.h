@@ -0,0 +1,76 @@
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "lexer.h"
+
+class TokenBuffer;
+
+// Read-only view of a cached token stream, mapped straight from the cache
+// file. Offers the same accessors as TokenBuffer. Token text points into
+// the source the stream was loaded for.
+class CachedTokens {
+private:
+    void* mapping;
+    size_t mappingLength;
+    const char* source;
+    size_t count;
+    const uint32_t* offsets;
+    const uint32_t* lengths;
+    const uint32_t* lines;
+    const uint8_t* kinds;
+
+    void release();
+
+    friend class TokenCache;
+
+public:
+    CachedTokens();
+    ~CachedTokens();
+
+    CachedTokens(const CachedTokens&) = delete;
+    CachedTokens& operator=(const CachedTokens&) = delete;
+
+    size_t size() const { return count; }
+    TokenType type(size_t index) const { return static_cast<TokenType>(kinds[index]); }
+    size_t offset(size_t index) const { return offsets[index]; }
+    size_t length(size_t index) const { return lengths[index]; }
+    std::string_view text(size_t index) const {
+        return std::string_view(source + offsets[index], lengths[index]);
+    }
+    size_t line(size_t index) const { return lines[index]; }
+    // Found by looking back for the start of the line
+    size_t column(size_t index) const;
+
+    Token at(size_t index) const;
+};
+
+// Directory of token streams, one file per distinct source content.
+// A file is named after a 64-bit hash of the source and also records the
+// source length and a fingerprint of the lexer (format version, DFA tables
+// and reserved words), so changing either the file or the lexer makes the
+// old entry miss and get rewritten.
+// Layout, native byte order: a 40-byte header, then uint32_t offsets[n],
+// lengths[n] and lines[n], then uint8_t kinds[n].
+class TokenCache {
+private:
+    std::string directory;
+
+    std::string entryPath(uint64_t contentHash) const;
+
+public:
+    explicit TokenCache(std::string dir);
+
+    // Maps the stream for 'source' into 'out'; false on a miss
+    bool load(std::string_view source, CachedTokens& out) const;
+    // Writes the stream for 'source', replacing any stale entry atomically
+    bool store(std::string_view source, const TokenBuffer& tokens) const;
+
+    // Fast 64-bit hash used to key the cache
+    static uint64_t hashContent(std::string_view data);
+};
+
+#endif // TOKEN_CACHE_H
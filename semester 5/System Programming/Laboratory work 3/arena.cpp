@@ -0,0 +1,44 @@
+#include "arena.h"
+#include <cstdio>
+#include <cstdlib>
+
+Arena::Arena(size_t blockSize)
+    : blocks(nullptr), cursor(nullptr), limit(nullptr), blockSize(blockSize),
+      usedBytes(0), reservedBytes(0) {}
+
+Arena::~Arena() {
+    reset();
+}
+
+void Arena::reset() {
+    while (blocks) {
+        Block* next = blocks->next;
+        std::free(blocks);
+        blocks = next;
+    }
+    cursor = nullptr;
+    limit = nullptr;
+    usedBytes = 0;
+    reservedBytes = 0;
+}
+
+void* Arena::allocateSlow(size_t size, size_t align) {
+    // Oversized requests get a block of their own
+    size_t payload = size + align > blockSize ? size + align : blockSize;
+    size_t total = sizeof(Block) + payload;
+    Block* block = static_cast<Block*>(std::malloc(total));
+    if (!block) {
+        std::fprintf(stderr, "Out of memory allocating %zu bytes for the AST\n", total);
+        std::exit(EXIT_FAILURE);
+    }
+    block->next = blocks;
+    blocks = block;
+    reservedBytes += total;
+
+    char* start = reinterpret_cast<char*>(block + 1);
+    size_t padding = (align - reinterpret_cast<size_t>(start) % align) % align;
+    cursor = start + padding + size;
+    limit = start + payload;
+    usedBytes += size;
+    return start + padding;
+}
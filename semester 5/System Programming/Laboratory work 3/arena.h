@@ -0,0 +1,142 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Bump-pointer allocator that owns every AST node of a translation unit.
+// Objects are carved out of large blocks and are never destroyed one by one:
+// reset() or the destructor releases all blocks at once, so only trivially
+// destructible types may be placed in an arena.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align) {
+        size_t padding = (align - reinterpret_cast<size_t>(cursor) % align) % align;
+        if (cursor && padding + size <= static_cast<size_t>(limit - cursor)) {
+            void* result = cursor + padding;
+            cursor += padding + size;
+            usedBytes += size;
+            return result;
+        }
+        return allocateSlow(size, align);
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena objects are released without running destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena objects are released without running destructors");
+        return count ? static_cast<T*>(allocate(sizeof(T) * count, alignof(T))) : nullptr;
+    }
+
+    // Copies text into the arena; the view stays valid until reset()
+    std::string_view copyString(std::string_view text) {
+        char* copy = static_cast<char*>(allocate(text.size() + 1, 1));
+        std::memcpy(copy, text.data(), text.size());
+        copy[text.size()] = '\0';
+        return std::string_view(copy, text.size());
+    }
+
+    // Frees every block; all pointers into the arena become invalid
+    void reset();
+
+    size_t bytesUsed() const { return usedBytes; }
+    size_t bytesReserved() const { return reservedBytes; }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    Block* blocks;
+    char* cursor;
+    char* limit;
+    size_t blockSize;
+    size_t usedBytes;       // Bytes handed out, excluding padding
+    size_t reservedBytes;   // Bytes obtained from malloc
+
+    void* allocateSlow(size_t size, size_t align);
+};
+
+// Fixed-size array of T living in an arena; used for AST child lists
+template <typename T>
+class ArenaSpan {
+public:
+    ArenaSpan() : items(nullptr), count(0) {}
+    ArenaSpan(T* items, size_t count) : items(items), count(count) {}
+
+    T* begin() const { return items; }
+    T* end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t index) const { return items[index]; }
+
+    // Drops the elements from newSize on; the storage stays in the arena
+    void truncate(size_t newSize) {
+        if (newSize < count) {
+            count = newSize;
+        }
+    }
+
+private:
+    T* items;
+    size_t count;
+};
+
+// Collects list elements in arena links while the parser reduces a list rule,
+// then copies them into one contiguous ArenaSpan.
+template <typename T>
+class ArenaListBuilder {
+public:
+    ArenaListBuilder() : head(nullptr), tail(nullptr), count(0) {}
+
+    void append(Arena& arena, const T& value) {
+        Link* link = arena.make<Link>(Link{value, nullptr});
+        if (tail) {
+            tail->next = link;
+        } else {
+            head = link;
+        }
+        tail = link;
+        count++;
+    }
+
+    size_t size() const { return count; }
+
+    ArenaSpan<T> finish(Arena& arena) const {
+        T* items = arena.allocateArray<T>(count);
+        size_t i = 0;
+        for (Link* link = head; link; link = link->next) {
+            new (&items[i++]) T(link->value);
+        }
+        return ArenaSpan<T>(items, count);
+    }
+
+private:
+    struct Link {
+        T value;
+        Link* next;
+    };
+
+    Link* head;
+    Link* tail;
+    size_t count;
+};
+
+#endif // ARENA_H
@@ -2,9 +2,11 @@
 #define AST_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <memory>
 #include <cstdint>
+#include "arena.h"
+#include "interner.h"
 
 // Forward declarations
 class ASTNode;
@@ -12,6 +14,47 @@ class ExpressionNode;
 class StatementNode;
 class BlockNode;
 
+// Operators of BinaryOpNode and UnaryOpNode
+enum class Operator : uint8_t {
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+    EQ,
+    NE,
+    LT,
+    GT,
+    LE,
+    GE,
+    AND,
+    OR,
+    ASSIGN,
+    NOT,
+    NEG,
+    PLUS
+};
+
+// Source spelling of an operator, e.g. "<=" for Operator::LE
+const char* operatorSymbol(Operator op);
+
+// Resolved type of an expression. The arithmetic types are in promotion
+// order, so the wider of two is the larger value.
+enum class TypeId : uint8_t {
+    UNKNOWN,
+    VOID,
+    STRING,
+    CHAR,
+    INT,
+    FLOAT,
+    DOUBLE
+};
+
+// Name of a type as written in source, "unknown" for TypeId::UNKNOWN
+const char* typeName(TypeId type);
+// TypeId of a type_specifier name such as "int"; UNKNOWN for anything else
+TypeId typeFromName(std::string_view name);
+
 // Base AST node class
 class ASTNode {
 public:
@@ -36,14 +79,14 @@ public:
     };
 
     ASTNode(NodeType type, int line = 0) : nodeType(type), lineNumber(line) {}
-    virtual ~ASTNode() = default;
     
     NodeType getType() const { return nodeType; }
     int getLine() const { return lineNumber; }
-    
-    virtual std::string toJSON(int indent = 0) const = 0;
 
 protected:
+    // Nodes live in an Arena and are never destroyed individually
+    ~ASTNode() = default;
+
     NodeType nodeType;
     int lineNumber;
 };
@@ -51,69 +94,79 @@ protected:
 // Expression base class
 class ExpressionNode : public ASTNode {
 public:
-    ExpressionNode(NodeType type, int line = 0) : ASTNode(type, line) {}
+    ExpressionNode(NodeType type, int line = 0)
+        : ASTNode(type, line), resolvedType(TypeId::UNKNOWN) {}
+
+    // Set by SemanticAnalyzer; literals know theirs from the start
+    TypeId getResolvedType() const { return resolvedType; }
+    void setResolvedType(TypeId type) { resolvedType = type; }
+
+private:
+    TypeId resolvedType;
 };
 
 // Binary operation node
 class BinaryOpNode : public ExpressionNode {
 public:
-    BinaryOpNode(const std::string& op, std::unique_ptr<ExpressionNode> left,
-                 std::unique_ptr<ExpressionNode> right, int line = 0)
-        : ExpressionNode(NODE_BINARY_OP, line), op(op),
-          left(std::move(left)), right(std::move(right)) {}
+    BinaryOpNode(Operator op, ExpressionNode* left, ExpressionNode* right, int line = 0)
+        : ExpressionNode(NODE_BINARY_OP, line), op(op), left(left), right(right) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getOp() const { return op; }
-    ExpressionNode* getLeft() const { return left.get(); }
-    ExpressionNode* getRight() const { return right.get(); }
+    Operator getOp() const { return op; }
+    ExpressionNode* getLeft() const { return left; }
+    ExpressionNode* getRight() const { return right; }
+    void setLeft(ExpressionNode* expr) { left = expr; }
+    void setRight(ExpressionNode* expr) { right = expr; }
 
 private:
-    std::string op;
-    std::unique_ptr<ExpressionNode> left;
-    std::unique_ptr<ExpressionNode> right;
+    Operator op;
+    ExpressionNode* left;
+    ExpressionNode* right;
 };
 
 // Unary operation node
 class UnaryOpNode : public ExpressionNode {
 public:
-    UnaryOpNode(const std::string& op, std::unique_ptr<ExpressionNode> operand, int line = 0)
-        : ExpressionNode(NODE_UNARY_OP, line), op(op), operand(std::move(operand)) {}
+    UnaryOpNode(Operator op, ExpressionNode* operand, int line = 0)
+        : ExpressionNode(NODE_UNARY_OP, line), op(op), operand(operand) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getOp() const { return op; }
-    ExpressionNode* getOperand() const { return operand.get(); }
+    Operator getOp() const { return op; }
+    ExpressionNode* getOperand() const { return operand; }
+    void setOperand(ExpressionNode* expr) { operand = expr; }
 
 private:
-    std::string op;
-    std::unique_ptr<ExpressionNode> operand;
+    Operator op;
+    ExpressionNode* operand;
 };
 
 // Literal node
 class LiteralNode : public ExpressionNode {
 public:
-    LiteralNode(const std::string& value, const std::string& type, int line = 0)
-        : ExpressionNode(NODE_LITERAL, line), value(value), literalType(type) {}
+    LiteralNode(SymbolId value, std::string_view type, int line = 0)
+        : ExpressionNode(NODE_LITERAL, line), value(value), literalType(type) {
+        // An unsuffixed floating constant is a double in C
+        setResolvedType(type == "float" ? TypeId::DOUBLE
+                         : type == "string" ? TypeId::STRING
+                         : typeFromName(type));
+    }
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getValue() const { return value; }
-    const std::string& getLiteralType() const { return literalType; }
+    SymbolId getValue() const { return value; }
+    std::string_view getLiteralType() const { return literalType; }
 
 private:
-    std::string value;
-    std::string literalType;
+    SymbolId value;             // Source spelling of the literal
+    std::string_view literalType;
 };
 
 // Identifier node
 class IdentifierNode : public ExpressionNode {
 public:
-    IdentifierNode(const std::string& name, int line = 0)
+    IdentifierNode(SymbolId name, int line = 0)
         : ExpressionNode(NODE_IDENTIFIER, line), name(name) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getName() const { return name; }
+    SymbolId getName() const { return name; }
 
 private:
-    std::string name;
+    SymbolId name;
 };
 
 // Statement base class
@@ -125,209 +178,232 @@ public:
 // If statement node
 class IfNode : public StatementNode {
 public:
-    IfNode(std::unique_ptr<ExpressionNode> condition,
-           std::unique_ptr<BlockNode> thenBlock,
-           std::unique_ptr<BlockNode> elseBlock,
-           int line = 0)
+    IfNode(ExpressionNode* condition, BlockNode* thenBlock, BlockNode* elseBlock, int line = 0)
         : StatementNode(NODE_IF, line),
-          condition(std::move(condition)),
-          thenBlock(std::move(thenBlock)),
-          elseBlock(std::move(elseBlock)) {}
+          condition(condition),
+          thenBlock(thenBlock),
+          elseBlock(elseBlock) {}
     
-    std::string toJSON(int indent = 0) const override;
-    ExpressionNode* getCondition() const { return condition.get(); }
-    BlockNode* getThenBlock() const { return thenBlock.get(); }
-    BlockNode* getElseBlock() const { return elseBlock.get(); }
+    ExpressionNode* getCondition() const { return condition; }
+    BlockNode* getThenBlock() const { return thenBlock; }
+    BlockNode* getElseBlock() const { return elseBlock; }
+    void setCondition(ExpressionNode* expr) { condition = expr; }
 
 private:
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<BlockNode> thenBlock;
-    std::unique_ptr<BlockNode> elseBlock;
+    ExpressionNode* condition;
+    BlockNode* thenBlock;
+    BlockNode* elseBlock;
 };
 
 // While loop node
 class WhileNode : public StatementNode {
 public:
-    WhileNode(std::unique_ptr<ExpressionNode> condition,
-              std::unique_ptr<BlockNode> body,
-              int line = 0)
+    WhileNode(ExpressionNode* condition, BlockNode* body, int line = 0)
         : StatementNode(NODE_WHILE, line),
-          condition(std::move(condition)),
-          body(std::move(body)) {}
+          condition(condition),
+          body(body) {}
     
-    std::string toJSON(int indent = 0) const override;
-    ExpressionNode* getCondition() const { return condition.get(); }
-    BlockNode* getBody() const { return body.get(); }
+    ExpressionNode* getCondition() const { return condition; }
+    BlockNode* getBody() const { return body; }
+    void setCondition(ExpressionNode* expr) { condition = expr; }
 
 private:
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<BlockNode> body;
+    ExpressionNode* condition;
+    BlockNode* body;
 };
 
 // For loop node
 class ForNode : public StatementNode {
 public:
-    ForNode(std::unique_ptr<StatementNode> init,
-            std::unique_ptr<ExpressionNode> condition,
-            std::unique_ptr<ExpressionNode> increment,
-            std::unique_ptr<BlockNode> body,
+    ForNode(StatementNode* init,
+            ExpressionNode* condition,
+            ExpressionNode* increment,
+            BlockNode* body,
             int line = 0)
         : StatementNode(NODE_FOR, line),
-          init(std::move(init)),
-          condition(std::move(condition)),
-          increment(std::move(increment)),
-          body(std::move(body)) {}
+          init(init),
+          condition(condition),
+          increment(increment),
+          body(body) {}
     
-    std::string toJSON(int indent = 0) const override;
-    StatementNode* getInit() const { return init.get(); }
-    ExpressionNode* getCondition() const { return condition.get(); }
-    ExpressionNode* getIncrement() const { return increment.get(); }
-    BlockNode* getBody() const { return body.get(); }
+    StatementNode* getInit() const { return init; }
+    ExpressionNode* getCondition() const { return condition; }
+    ExpressionNode* getIncrement() const { return increment; }
+    BlockNode* getBody() const { return body; }
+    void setCondition(ExpressionNode* expr) { condition = expr; }
+    void setIncrement(ExpressionNode* expr) { increment = expr; }
 
 private:
-    std::unique_ptr<StatementNode> init;
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<ExpressionNode> increment;
-    std::unique_ptr<BlockNode> body;
+    StatementNode* init;
+    ExpressionNode* condition;
+    ExpressionNode* increment;
+    BlockNode* body;
+};
+
+// Function parameter: type and name
+struct Parameter {
+    SymbolId type;
+    SymbolId name;
 };
 
 // Function definition node
 class FunctionNode : public StatementNode {
 public:
-    FunctionNode(const std::string& name,
-                 const std::string& returnType,
-                 std::vector<std::pair<std::string, std::string>> params,
-                 std::unique_ptr<BlockNode> body,
+    FunctionNode(SymbolId name,
+                 SymbolId returnType,
+                 ArenaSpan<Parameter> params,
+                 BlockNode* body,
                  int line = 0)
         : StatementNode(NODE_FUNCTION, line),
           name(name),
           returnType(returnType),
-          params(std::move(params)),
-          body(std::move(body)) {}
+          params(params),
+          body(body) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getName() const { return name; }
-    const std::string& getReturnType() const { return returnType; }
-    const std::vector<std::pair<std::string, std::string>>& getParams() const { return params; }
-    BlockNode* getBody() const { return body.get(); }
+    SymbolId getName() const { return name; }
+    SymbolId getReturnType() const { return returnType; }
+    const ArenaSpan<Parameter>& getParams() const { return params; }
+    BlockNode* getBody() const { return body; }
 
 private:
-    std::string name;
-    std::string returnType;
-    std::vector<std::pair<std::string, std::string>> params;
-    std::unique_ptr<BlockNode> body;
+    SymbolId name;
+    SymbolId returnType;
+    ArenaSpan<Parameter> params;
+    BlockNode* body;
 };
 
 // Function call node
 class CallNode : public ExpressionNode {
 public:
-    CallNode(const std::string& name,
-             std::vector<std::unique_ptr<ExpressionNode>> args,
-             int line = 0)
+    CallNode(SymbolId name, ArenaSpan<ExpressionNode*> args, int line = 0)
         : ExpressionNode(NODE_CALL, line),
           name(name),
-          args(std::move(args)) {}
+          args(args) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getName() const { return name; }
-    const std::vector<std::unique_ptr<ExpressionNode>>& getArgs() const { return args; }
+    SymbolId getName() const { return name; }
+    ArenaSpan<ExpressionNode*>& getArgs() { return args; }
+    const ArenaSpan<ExpressionNode*>& getArgs() const { return args; }
 
 private:
-    std::string name;
-    std::vector<std::unique_ptr<ExpressionNode>> args;
+    SymbolId name;
+    ArenaSpan<ExpressionNode*> args;
 };
 
 // Variable declaration node
 class VarDeclNode : public StatementNode {
 public:
-    VarDeclNode(const std::string& type,
-                const std::string& name,
-                std::unique_ptr<ExpressionNode> initializer,
+    VarDeclNode(SymbolId type,
+                SymbolId name,
+                ExpressionNode* initializer,
                 int line = 0)
         : StatementNode(NODE_VAR_DECL, line),
           varType(type),
           name(name),
-          initializer(std::move(initializer)) {}
+          initializer(initializer) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getVarType() const { return varType; }
-    const std::string& getName() const { return name; }
-    ExpressionNode* getInitializer() const { return initializer.get(); }
+    SymbolId getVarType() const { return varType; }
+    SymbolId getName() const { return name; }
+    ExpressionNode* getInitializer() const { return initializer; }
+    void setInitializer(ExpressionNode* expr) { initializer = expr; }
 
 private:
-    std::string varType;
-    std::string name;
-    std::unique_ptr<ExpressionNode> initializer;
+    SymbolId varType;
+    SymbolId name;
+    ExpressionNode* initializer;
 };
 
 // Assignment node
 class AssignNode : public StatementNode {
 public:
-    AssignNode(const std::string& name,
-               std::unique_ptr<ExpressionNode> value,
-               int line = 0)
+    AssignNode(SymbolId name, ExpressionNode* value, int line = 0)
         : StatementNode(NODE_ASSIGN, line),
           name(name),
-          value(std::move(value)) {}
+          value(value) {}
     
-    std::string toJSON(int indent = 0) const override;
-    const std::string& getName() const { return name; }
-    ExpressionNode* getValue() const { return value.get(); }
+    SymbolId getName() const { return name; }
+    ExpressionNode* getValue() const { return value; }
+    void setValue(ExpressionNode* expr) { value = expr; }
 
 private:
-    std::string name;
-    std::unique_ptr<ExpressionNode> value;
+    SymbolId name;
+    ExpressionNode* value;
 };
 
 // Block node
 class BlockNode : public StatementNode {
 public:
-    BlockNode(std::vector<std::unique_ptr<StatementNode>> statements, int line = 0)
+    BlockNode(ArenaSpan<StatementNode*> statements, int line = 0)
         : StatementNode(NODE_BLOCK, line),
-          statements(std::move(statements)) {}
+          statements(statements) {}
     
-    std::string toJSON(int indent = 0) const override;
-    std::vector<std::unique_ptr<StatementNode>>& getStatements() {
+    ArenaSpan<StatementNode*>& getStatements() {
         return statements;
     }
-    const std::vector<std::unique_ptr<StatementNode>>& getStatements() const {
+    const ArenaSpan<StatementNode*>& getStatements() const {
         return statements;
     }
 
 private:
-    std::vector<std::unique_ptr<StatementNode>> statements;
+    ArenaSpan<StatementNode*> statements;
 };
 
 // Return statement node
 class ReturnNode : public StatementNode {
 public:
-    ReturnNode(std::unique_ptr<ExpressionNode> value, int line = 0)
+    ReturnNode(ExpressionNode* value, int line = 0)
         : StatementNode(NODE_RETURN, line),
-          value(std::move(value)) {}
+          value(value) {}
     
-    std::string toJSON(int indent = 0) const override;
-    ExpressionNode* getValue() const { return value.get(); }
+    ExpressionNode* getValue() const { return value; }
+    void setValue(ExpressionNode* expr) { value = expr; }
 
 private:
-    std::unique_ptr<ExpressionNode> value;
+    ExpressionNode* value;
 };
 
 // Break statement node
 class BreakNode : public StatementNode {
 public:
     BreakNode(int line = 0) : StatementNode(NODE_BREAK, line) {}
-    std::string toJSON(int indent = 0) const override;
 };
 
 // Continue statement node
 class ContinueNode : public StatementNode {
 public:
     ContinueNode(int line = 0) : StatementNode(NODE_CONTINUE, line) {}
-    std::string toJSON(int indent = 0) const override;
 };
 
-// Helper function for JSON indentation
-std::string indentString(int level);
+// Top-level statements of one source file. Every node and child list of the
+// tree is allocated from the unit's arena and every name is interned in its
+// string table, so clear() and the destructor free the whole tree without
+// visiting it.
+class TranslationUnit {
+public:
+    TranslationUnit() = default;
+    TranslationUnit(const TranslationUnit&) = delete;
+    TranslationUnit& operator=(const TranslationUnit&) = delete;
+
+    Arena& getArena() { return arena; }
+    const Arena& getArena() const { return arena; }
+    StringInterner& getNames() { return names; }
+    const StringInterner& getNames() const { return names; }
+
+    void add(StatementNode* stmt) { statements.push_back(stmt); }
+    std::vector<StatementNode*>& getStatements() { return statements; }
+    const std::vector<StatementNode*>& getStatements() const { return statements; }
+    size_t size() const { return statements.size(); }
+
+    void clear() {
+        statements.clear();
+        arena.reset();
+        names.clear();
+    }
+
+private:
+    Arena arena;
+    StringInterner names;
+    std::vector<StatementNode*> statements;
+};
 
 #endif // AST_H
 
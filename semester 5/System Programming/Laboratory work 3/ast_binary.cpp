@@ -0,0 +1,511 @@
+#include "ast_binary.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace astbin {
+
+static const char MAGIC[4] = {'C', 'A', 'S', 'T'};
+
+namespace {
+
+// Flattens the tree: children are emitted before their parent
+class Encoder {
+public:
+    std::vector<BinaryNode> nodes;
+    std::vector<uint32_t> lists;
+
+    uint32_t encode(const ASTNode* node) {
+        if (!node) {
+            return NO_INDEX;
+        }
+
+        BinaryNode record = {static_cast<uint8_t>(node->getType()), 0, 0,
+                             static_cast<uint32_t>(node->getLine()),
+                             NO_INDEX, NO_INDEX, NO_INDEX, NO_INDEX};
+
+        switch (node->getType()) {
+            case ASTNode::NODE_BINARY_OP: {
+                const BinaryOpNode* bin = static_cast<const BinaryOpNode*>(node);
+                record.op = static_cast<uint8_t>(bin->getOp());
+                record.a = encode(bin->getLeft());
+                record.b = encode(bin->getRight());
+                break;
+            }
+            case ASTNode::NODE_UNARY_OP: {
+                const UnaryOpNode* un = static_cast<const UnaryOpNode*>(node);
+                record.op = static_cast<uint8_t>(un->getOp());
+                record.a = encode(un->getOperand());
+                break;
+            }
+            case ASTNode::NODE_LITERAL: {
+                const LiteralNode* lit = static_cast<const LiteralNode*>(node);
+                record.a = lit->getValue();
+                record.b = literalType(lit->getLiteralType());
+                break;
+            }
+            case ASTNode::NODE_IDENTIFIER:
+                record.a = static_cast<const IdentifierNode*>(node)->getName();
+                break;
+            case ASTNode::NODE_IF: {
+                const IfNode* ifNode = static_cast<const IfNode*>(node);
+                record.a = encode(ifNode->getCondition());
+                record.b = encode(ifNode->getThenBlock());
+                record.c = encode(ifNode->getElseBlock());
+                break;
+            }
+            case ASTNode::NODE_WHILE: {
+                const WhileNode* whileNode = static_cast<const WhileNode*>(node);
+                record.a = encode(whileNode->getCondition());
+                record.b = encode(whileNode->getBody());
+                break;
+            }
+            case ASTNode::NODE_FOR: {
+                const ForNode* forNode = static_cast<const ForNode*>(node);
+                record.a = encode(forNode->getInit());
+                record.b = encode(forNode->getCondition());
+                record.c = encode(forNode->getIncrement());
+                record.d = encode(forNode->getBody());
+                break;
+            }
+            case ASTNode::NODE_FUNCTION: {
+                const FunctionNode* func = static_cast<const FunctionNode*>(node);
+                record.a = func->getName();
+                record.b = func->getReturnType();
+                record.c = encode(func->getBody());
+                record.d = static_cast<uint32_t>(lists.size());
+                lists.push_back(static_cast<uint32_t>(func->getParams().size()));
+                for (const Parameter& param : func->getParams()) {
+                    lists.push_back(param.type);
+                    lists.push_back(param.name);
+                }
+                break;
+            }
+            case ASTNode::NODE_CALL: {
+                const CallNode* call = static_cast<const CallNode*>(node);
+                record.a = call->getName();
+                record.b = encodeList(call->getArgs());
+                break;
+            }
+            case ASTNode::NODE_VAR_DECL: {
+                const VarDeclNode* decl = static_cast<const VarDeclNode*>(node);
+                record.a = decl->getVarType();
+                record.b = decl->getName();
+                record.c = encode(decl->getInitializer());
+                break;
+            }
+            case ASTNode::NODE_ASSIGN: {
+                const AssignNode* assign = static_cast<const AssignNode*>(node);
+                record.a = assign->getName();
+                record.b = encode(assign->getValue());
+                break;
+            }
+            case ASTNode::NODE_BLOCK:
+                record.a = encodeList(static_cast<const BlockNode*>(node)->getStatements());
+                break;
+            case ASTNode::NODE_RETURN:
+                record.a = encode(static_cast<const ReturnNode*>(node)->getValue());
+                break;
+            default:
+                break;
+        }
+
+        nodes.push_back(record);
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    template <typename Items>
+    uint32_t encodeList(const Items& items) {
+        // Encode the items first so the list words stay contiguous
+        std::vector<uint32_t> indices;
+        indices.reserve(items.size());
+        for (const ASTNode* item : items) {
+            indices.push_back(encode(item));
+        }
+        uint32_t start = static_cast<uint32_t>(lists.size());
+        lists.push_back(static_cast<uint32_t>(indices.size()));
+        lists.insert(lists.end(), indices.begin(), indices.end());
+        return start;
+    }
+
+    // Literal type names are not interned; they are stored as a small code
+    static uint32_t literalType(std::string_view type) {
+        static const char* const TYPES[] = {"int", "float", "string", "char"};
+        for (uint32_t i = 0; i < 4; i++) {
+            if (type == TYPES[i]) {
+                return i;
+            }
+        }
+        return 0;
+    }
+};
+
+bool writeAll(std::FILE* file, const void* data, size_t bytes) {
+    return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+}
+
+bool isStatementKind(uint8_t kind) {
+    switch (kind) {
+        case ASTNode::NODE_IF:
+        case ASTNode::NODE_WHILE:
+        case ASTNode::NODE_FOR:
+        case ASTNode::NODE_FUNCTION:
+        case ASTNode::NODE_VAR_DECL:
+        case ASTNode::NODE_ASSIGN:
+        case ASTNode::NODE_BLOCK:
+        case ASTNode::NODE_RETURN:
+        case ASTNode::NODE_BREAK:
+        case ASTNode::NODE_CONTINUE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isExpressionKind(uint8_t kind) {
+    switch (kind) {
+        case ASTNode::NODE_BINARY_OP:
+        case ASTNode::NODE_UNARY_OP:
+        case ASTNode::NODE_LITERAL:
+        case ASTNode::NODE_IDENTIFIER:
+        case ASTNode::NODE_CALL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+bool write(const TranslationUnit& unit, const std::string& filename) {
+    Encoder encoder;
+    uint32_t rootList = encoder.encodeList(unit.getStatements());
+
+    const StringInterner& names = unit.getNames();
+    std::vector<uint32_t> offsets;
+    offsets.reserve(names.size() + 1);
+    uint32_t bytes = 0;
+    for (SymbolId id = 0; id < names.size(); id++) {
+        offsets.push_back(bytes);
+        bytes += static_cast<uint32_t>(names.text(id).size());
+    }
+    offsets.push_back(bytes);
+
+    AstFileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.nodeCount = static_cast<uint32_t>(encoder.nodes.size());
+    header.listWords = static_cast<uint32_t>(encoder.lists.size());
+    header.stringCount = static_cast<uint32_t>(names.size());
+    header.stringBytes = bytes;
+    header.rootList = rootList;
+    header.reserved = 0;
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool ok = writeAll(file, &header, sizeof(header)) &&
+              writeAll(file, encoder.nodes.data(), encoder.nodes.size() * sizeof(BinaryNode)) &&
+              writeAll(file, encoder.lists.data(), encoder.lists.size() * sizeof(uint32_t)) &&
+              writeAll(file, offsets.data(), offsets.size() * sizeof(uint32_t));
+    for (SymbolId id = 0; ok && id < names.size(); id++) {
+        std::string_view text = names.text(id);
+        ok = writeAll(file, text.data(), text.size());
+    }
+    if (std::fclose(file) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+bool isBinaryAst(const std::string& filename) {
+    char magic[sizeof(MAGIC)];
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    bool matches = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                   std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    std::fclose(file);
+    return matches;
+}
+
+AstFile::AstFile()
+    : mapping(nullptr), mappingLength(0), header(nullptr), nodes(nullptr),
+      lists(nullptr), stringOffsets(nullptr), strings(nullptr) {}
+
+AstFile::~AstFile() {
+    close();
+}
+
+void AstFile::close() {
+    if (mapping) {
+        munmap(mapping, mappingLength);
+    }
+    mapping = nullptr;
+    mappingLength = 0;
+    header = nullptr;
+}
+
+bool AstFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(AstFileHeader)) {
+        ::close(fd);
+        std::cerr << "Error: " << filename << " is not a binary AST file" << std::endl;
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error: Cannot map file " << filename << std::endl;
+        return false;
+    }
+    mapping = mapped;
+    mappingLength = size;
+
+    const char* base = static_cast<const char*>(mapped);
+    header = reinterpret_cast<const AstFileHeader*>(base);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != FORMAT_VERSION) {
+        std::cerr << "Error: " << filename << " is not a binary AST file of version "
+                  << FORMAT_VERSION << std::endl;
+        close();
+        return false;
+    }
+
+    // Every section must lie inside the file
+    size_t nodesAt = sizeof(AstFileHeader);
+    size_t listsAt = nodesAt + static_cast<size_t>(header->nodeCount) * sizeof(BinaryNode);
+    size_t offsetsAt = listsAt + static_cast<size_t>(header->listWords) * sizeof(uint32_t);
+    size_t stringsAt = offsetsAt + (static_cast<size_t>(header->stringCount) + 1) * sizeof(uint32_t);
+    if (stringsAt + header->stringBytes != size) {
+        std::cerr << "Error: " << filename << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    nodes = reinterpret_cast<const BinaryNode*>(base + nodesAt);
+    lists = reinterpret_cast<const uint32_t*>(base + listsAt);
+    stringOffsets = reinterpret_cast<const uint32_t*>(base + offsetsAt);
+    strings = base + stringsAt;
+
+    // String offsets must be ascending and end at the end of the file
+    bool valid = validList(header->rootList) && stringOffsets[0] == 0 &&
+                 stringOffsets[header->stringCount] == header->stringBytes;
+    for (uint32_t id = 0; valid && id < header->stringCount; id++) {
+        valid = stringOffsets[id] <= stringOffsets[id + 1];
+    }
+    if (!valid) {
+        std::cerr << "Error: " << filename << " is truncated or corrupt" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AstFile::validList(uint32_t index) const {
+    return index < header->listWords && lists[index] <= header->listWords - index - 1;
+}
+
+bool AstFile::load(TranslationUnit& unit) const {
+    unit.clear();
+
+    // Strings go back in id order, so the ids in the nodes stay valid
+    StringInterner& names = unit.getNames();
+    for (SymbolId id = 0; id < header->stringCount; id++) {
+        if (names.intern(text(id)) != id) {
+            return false;
+        }
+    }
+
+    static const char* const LITERAL_TYPES[] = {"int", "float", "string", "char"};
+    Arena& arena = unit.getArena();
+    std::vector<ASTNode*> built(header->nodeCount, nullptr);
+    uint32_t stringCount = header->stringCount;
+
+    // Children precede their parents, so one forward pass builds the tree
+    auto expression = [&](uint32_t index, uint32_t parent, ExpressionNode*& out) {
+        if (index == NO_INDEX) {
+            out = nullptr;
+            return true;
+        }
+        if (index >= parent || !isExpressionKind(nodes[index].kind)) {
+            return false;
+        }
+        out = static_cast<ExpressionNode*>(built[index]);
+        return true;
+    };
+    auto statement = [&](uint32_t index, uint32_t parent, StatementNode*& out) {
+        if (index == NO_INDEX) {
+            out = nullptr;
+            return true;
+        }
+        if (index >= parent || !isStatementKind(nodes[index].kind)) {
+            return false;
+        }
+        out = static_cast<StatementNode*>(built[index]);
+        return true;
+    };
+    auto block = [&](uint32_t index, uint32_t parent, BlockNode*& out) {
+        if (index != NO_INDEX && (index >= parent || nodes[index].kind != ASTNode::NODE_BLOCK)) {
+            return false;
+        }
+        out = index == NO_INDEX ? nullptr : static_cast<BlockNode*>(built[index]);
+        return true;
+    };
+    auto name = [&](uint32_t id) { return id < stringCount; };
+
+    for (uint32_t i = 0; i < header->nodeCount; i++) {
+        const BinaryNode& n = nodes[i];
+        int line = static_cast<int>(n.line);
+        ExpressionNode* e1;
+        ExpressionNode* e2;
+        StatementNode* s1;
+        BlockNode* b1;
+        BlockNode* b2;
+
+        switch (n.kind) {
+            case ASTNode::NODE_BINARY_OP:
+                if (n.op > static_cast<uint8_t>(Operator::ASSIGN) || !expression(n.a, i, e1) || !expression(n.b, i, e2)) {
+                    return false;
+                }
+                built[i] = arena.make<BinaryOpNode>(static_cast<Operator>(n.op), e1, e2, line);
+                break;
+            case ASTNode::NODE_UNARY_OP:
+                if (n.op < static_cast<uint8_t>(Operator::NOT) || n.op > static_cast<uint8_t>(Operator::PLUS) ||
+                    !expression(n.a, i, e1)) {
+                    return false;
+                }
+                built[i] = arena.make<UnaryOpNode>(static_cast<Operator>(n.op), e1, line);
+                break;
+            case ASTNode::NODE_LITERAL:
+                if (!name(n.a) || n.b >= 4) {
+                    return false;
+                }
+                built[i] = arena.make<LiteralNode>(n.a, LITERAL_TYPES[n.b], line);
+                break;
+            case ASTNode::NODE_IDENTIFIER:
+                if (!name(n.a)) {
+                    return false;
+                }
+                built[i] = arena.make<IdentifierNode>(n.a, line);
+                break;
+            case ASTNode::NODE_IF:
+                if (!expression(n.a, i, e1) || !block(n.b, i, b1) || !block(n.c, i, b2)) {
+                    return false;
+                }
+                built[i] = arena.make<IfNode>(e1, b1, b2, line);
+                break;
+            case ASTNode::NODE_WHILE:
+                if (!expression(n.a, i, e1) || !block(n.b, i, b1)) {
+                    return false;
+                }
+                built[i] = arena.make<WhileNode>(e1, b1, line);
+                break;
+            case ASTNode::NODE_FOR:
+                if (!statement(n.a, i, s1) || !expression(n.b, i, e1) || !expression(n.c, i, e2) ||
+                    !block(n.d, i, b1)) {
+                    return false;
+                }
+                built[i] = arena.make<ForNode>(s1, e1, e2, b1, line);
+                break;
+            case ASTNode::NODE_FUNCTION: {
+                if (!name(n.a) || !name(n.b) || !block(n.c, i, b1) || n.d >= header->listWords ||
+                    lists[n.d] > (header->listWords - n.d - 1) / 2) {
+                    return false;
+                }
+                uint32_t count = lists[n.d];
+                Parameter* params = arena.allocateArray<Parameter>(count);
+                for (uint32_t p = 0; p < count; p++) {
+                    uint32_t type = lists[n.d + 1 + 2 * p];
+                    uint32_t paramName = lists[n.d + 2 + 2 * p];
+                    if (!name(type) || !name(paramName)) {
+                        return false;
+                    }
+                    params[p] = Parameter{type, paramName};
+                }
+                built[i] = arena.make<FunctionNode>(n.a, n.b, ArenaSpan<Parameter>(params, count), b1, line);
+                break;
+            }
+            case ASTNode::NODE_CALL: {
+                if (!name(n.a) || !validList(n.b)) {
+                    return false;
+                }
+                List items = list(n.b);
+                ExpressionNode** args = arena.allocateArray<ExpressionNode*>(items.count);
+                for (uint32_t k = 0; k < items.count; k++) {
+                    if (items.items[k] == NO_INDEX || !expression(items.items[k], i, args[k])) {
+                        return false;
+                    }
+                }
+                built[i] = arena.make<CallNode>(n.a, ArenaSpan<ExpressionNode*>(args, items.count), line);
+                break;
+            }
+            case ASTNode::NODE_VAR_DECL:
+                if (!name(n.a) || !name(n.b) || !expression(n.c, i, e1)) {
+                    return false;
+                }
+                built[i] = arena.make<VarDeclNode>(n.a, n.b, e1, line);
+                break;
+            case ASTNode::NODE_ASSIGN:
+                if (!name(n.a) || !expression(n.b, i, e1)) {
+                    return false;
+                }
+                built[i] = arena.make<AssignNode>(n.a, e1, line);
+                break;
+            case ASTNode::NODE_BLOCK: {
+                if (!validList(n.a)) {
+                    return false;
+                }
+                List items = list(n.a);
+                StatementNode** statements = arena.allocateArray<StatementNode*>(items.count);
+                for (uint32_t k = 0; k < items.count; k++) {
+                    if (items.items[k] == NO_INDEX || !statement(items.items[k], i, statements[k])) {
+                        return false;
+                    }
+                }
+                built[i] = arena.make<BlockNode>(ArenaSpan<StatementNode*>(statements, items.count), line);
+                break;
+            }
+            case ASTNode::NODE_RETURN:
+                if (!expression(n.a, i, e1)) {
+                    return false;
+                }
+                built[i] = arena.make<ReturnNode>(e1, line);
+                break;
+            case ASTNode::NODE_BREAK:
+                built[i] = arena.make<BreakNode>(line);
+                break;
+            case ASTNode::NODE_CONTINUE:
+                built[i] = arena.make<ContinueNode>(line);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    List top = roots();
+    for (uint32_t k = 0; k < top.count; k++) {
+        StatementNode* stmt;
+        if (top.items[k] == NO_INDEX || !statement(top.items[k], header->nodeCount, stmt)) {
+            return false;
+        }
+        unit.add(stmt);
+    }
+    return true;
+}
+
+} // namespace astbin
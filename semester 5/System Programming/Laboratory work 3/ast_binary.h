@@ -0,0 +1,112 @@
+#ifndef AST_BINARY_H
+#define AST_BINARY_H
+
+#include "ast.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Binary AST file, written by --ast-bin and read back by mapping it.
+//
+// Layout (native byte order, every section 4-byte aligned):
+//   AstFileHeader
+//   BinaryNode  nodes[nodeCount]     children before parents (post-order)
+//   uint32_t    lists[listWords]     each list is {count, items...}
+//   uint32_t    stringOffsets[stringCount + 1]
+//   char        strings[stringBytes] the interner's table, in SymbolId order
+//
+// Child fields hold node indices (NO_INDEX for a missing child), list
+// fields hold the index of the list's count word, names hold SymbolIds.
+namespace astbin {
+
+const uint32_t FORMAT_VERSION = 1;
+const uint32_t NO_INDEX = 0xFFFFFFFFu;
+
+struct AstFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t listWords;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+    uint32_t rootList;      // Top-level statements
+    uint32_t reserved;
+};
+
+// One node; the meaning of a..d depends on kind:
+//   BINARY_OP   op, a = left, b = right       UNARY_OP  op, a = operand
+//   LITERAL     a = spelling, b = literal type (0 int, 1 float, 2 string, 3 char)
+//   IDENTIFIER  a = name
+//   IF          a = condition, b = then, c = else
+//   WHILE       a = condition, b = body
+//   FOR         a = init, b = condition, c = increment, d = body
+//   FUNCTION    a = name, b = return type, c = body,
+//               d = parameter list {count, type0, name0, type1, name1, ...}
+//   CALL        a = name, b = argument list
+//   VAR_DECL    a = type, b = name, c = initializer
+//   ASSIGN      a = name, b = value           RETURN    a = value
+//   BLOCK       a = statement list            BREAK, CONTINUE: no fields
+struct BinaryNode {
+    uint8_t kind;       // ASTNode::NodeType
+    uint8_t op;         // Operator for BINARY_OP and UNARY_OP
+    uint16_t reserved;
+    uint32_t line;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+};
+
+// Writes the unit to filename; false if the file cannot be written
+bool write(const TranslationUnit& unit, const std::string& filename);
+
+// True if filename starts with the binary AST magic
+bool isBinaryAst(const std::string& filename);
+
+// Read-only view of a mapped binary AST file. Opening only maps the file
+// and validates the header; the accessors read the mapped arrays in place.
+class AstFile {
+public:
+    struct List {
+        const uint32_t* items;
+        uint32_t count;
+    };
+
+    AstFile();
+    ~AstFile();
+
+    AstFile(const AstFile&) = delete;
+    AstFile& operator=(const AstFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    uint32_t nodeCount() const { return header->nodeCount; }
+    const BinaryNode& node(uint32_t index) const { return nodes[index]; }
+    List list(uint32_t index) const { return List{lists + index + 1, lists[index]}; }
+    List roots() const { return list(header->rootList); }
+    uint32_t stringCount() const { return header->stringCount; }
+    std::string_view text(SymbolId id) const {
+        return std::string_view(strings + stringOffsets[id], stringOffsets[id + 1] - stringOffsets[id]);
+    }
+
+    // Builds the tree in the unit's arena so the semantic analyzer and code
+    // generator can run on it. SymbolIds are preserved. Returns false if the
+    // file is malformed.
+    bool load(TranslationUnit& unit) const;
+
+private:
+    void* mapping;
+    size_t mappingLength;
+    const AstFileHeader* header;
+    const BinaryNode* nodes;
+    const uint32_t* lists;
+    const uint32_t* stringOffsets;
+    const char* strings;
+
+    bool validList(uint32_t index) const;
+};
+
+} // namespace astbin
+
+#endif // AST_BINARY_H
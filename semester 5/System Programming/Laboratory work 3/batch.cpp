@@ -0,0 +1,102 @@
+#include "batch.h"
+#include <cstdio>
+#include <iostream>
+#include "ast.h"
+#include "driver.h"
+#include "semantic.h"
+#include "thread_pool.h"
+
+namespace batch {
+
+std::vector<FileResult> parseFiles(const std::vector<std::string>& files,
+                                   size_t threadCount,
+                                   bool runSemantic) {
+    std::vector<FileResult> results(files.size());
+
+    // Files are handed out one at a time, so a few large files do not hold
+    // up the threads working through the small ones. Each tree is dropped
+    // as soon as its file is done, so memory follows the thread count
+    // rather than the number of files.
+    ThreadPool pool(threadCount);
+    pool.parallelFor(files.size(), [&](size_t index) {
+        FileResult& result = results[index];
+        result = FileResult{files[index], false, false, 0, 0, 0};
+
+        FILE* file = fopen(files[index].c_str(), "r");
+        if (!file) {
+            return;
+        }
+        result.opened = true;
+        if (fseek(file, 0, SEEK_END) == 0) {
+            long size = ftell(file);
+            result.bytes = size > 0 ? static_cast<size_t>(size) : 0;
+            rewind(file);
+        }
+
+        TranslationUnit unit;
+        result.parsed = parseFile(file, unit);
+        fclose(file);
+        if (!result.parsed) {
+            return;
+        }
+        result.statements = unit.size();
+
+        if (runSemantic) {
+            SemanticAnalyzer analyzer;
+            analyzer.analyze(unit);
+            for (char c : analyzer.getErrors()) {
+                if (c == '\n') {
+                    result.semanticErrors++;
+                }
+            }
+        }
+    });
+
+    return results;
+}
+
+void printReport(const std::vector<FileResult>& results, bool runSemantic, double seconds) {
+    size_t totalStatements = 0;
+    size_t totalErrors = 0;
+    size_t totalBytes = 0;
+    size_t unreadable = 0;
+    size_t failed = 0;
+
+    for (const auto& result : results) {
+        std::cout << result.path;
+        if (!result.opened) {
+            std::cout << ": cannot open\n";
+            unreadable++;
+            continue;
+        }
+        totalBytes += result.bytes;
+        if (!result.parsed) {
+            std::cout << ": parse error\n";
+            failed++;
+            continue;
+        }
+
+        std::cout << ": " << result.statements << " top-level statements, ";
+        if (runSemantic) {
+            std::cout << result.semanticErrors << " semantic errors, ";
+        }
+        std::cout << result.bytes << " bytes\n";
+
+        totalStatements += result.statements;
+        totalErrors += result.semanticErrors;
+    }
+
+    std::cout << "\nFiles: " << results.size();
+    if (unreadable > 0 || failed > 0) {
+        std::cout << " (" << unreadable << " unreadable, " << failed << " with parse errors)";
+    }
+    std::cout << "\nTop-level statements: " << totalStatements << "\n";
+    if (runSemantic) {
+        std::cout << "Semantic errors: " << totalErrors << "\n";
+    }
+    std::cout << "Bytes: " << totalBytes << "\n";
+    std::cout << "Time: " << seconds * 1000 << " ms ("
+              << (seconds > 0 ? totalBytes / seconds / (1 << 20) : 0) << " MB/s)" << std::endl;
+}
+
+} // namespace batch
@@ -0,0 +1,32 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Batch mode: parses many files in one process on a thread pool, each into
+// a TranslationUnit of its own
+namespace batch {
+
+struct FileResult {
+    std::string path;
+    bool opened;
+    bool parsed;
+    size_t bytes;
+    size_t statements;          // Top-level statements
+    size_t semanticErrors;
+};
+
+// Parses every file and, if asked, runs semantic analysis on it; results
+// come back in the order of 'files'
+std::vector<FileResult> parseFiles(const std::vector<std::string>& files,
+                                   size_t threadCount,
+                                   bool runSemantic);
+
+// One line per file followed by totals
+void printReport(const std::vector<FileResult>& results, bool runSemantic, double seconds);
+
+} // namespace batch
+
+#endif // BATCH_H
@@ -1,16 +1,17 @@
 #include "codegen.h"
 #include <iostream>
 
-CodeGenerator::CodeGenerator() : indentLevel(0) {
+CodeGenerator::CodeGenerator() : indentLevel(0), names(nullptr) {
 }
 
-std::string CodeGenerator::generate(std::vector<std::unique_ptr<StatementNode>>& ast) {
+std::string CodeGenerator::generate(const TranslationUnit& unit) {
+    names = &unit.getNames();
     output.str("");
     output.clear();
     indentLevel = 0;
     
-    for (auto& stmt : ast) {
-        generateStatement(stmt.get());
+    for (StatementNode* stmt : unit.getStatements()) {
+        generateStatement(stmt);
     }
     
     return output.str();
@@ -71,26 +72,26 @@ void CodeGenerator::generateExpression(ExpressionNode* expr) {
     switch (expr->getType()) {
         case ASTNode::NODE_LITERAL: {
             LiteralNode* lit = static_cast<LiteralNode*>(expr);
-            output << lit->getValue();
+            output << text(lit->getValue());
             break;
         }
         case ASTNode::NODE_IDENTIFIER: {
             IdentifierNode* id = static_cast<IdentifierNode*>(expr);
-            output << id->getName();
+            output << text(id->getName());
             break;
         }
         case ASTNode::NODE_BINARY_OP: {
             BinaryOpNode* bin = static_cast<BinaryOpNode*>(expr);
             output << "(";
             generateExpression(bin->getLeft());
-            output << " " << bin->getOp() << " ";
+            output << " " << operatorSymbol(bin->getOp()) << " ";
             generateExpression(bin->getRight());
             output << ")";
             break;
         }
         case ASTNode::NODE_UNARY_OP: {
             UnaryOpNode* un = static_cast<UnaryOpNode*>(expr);
-            output << un->getOp();
+            output << operatorSymbol(un->getOp());
             generateExpression(un->getOperand());
             break;
         }
@@ -107,11 +108,11 @@ void CodeGenerator::generateFunction(FunctionNode* func) {
     if (!func) return;
     
     indent();
-    output << func->getReturnType() << " " << func->getName() << "(";
+    output << text(func->getReturnType()) << " " << text(func->getName()) << "(";
     
     const auto& params = func->getParams();
     for (size_t i = 0; i < params.size(); i++) {
-        output << params[i].first << " " << params[i].second;
+        output << text(params[i].type) << " " << text(params[i].name);
         if (i < params.size() - 1) {
             output << ", ";
         }
@@ -137,7 +138,7 @@ void CodeGenerator::generateVarDecl(VarDeclNode* decl) {
     if (!decl) return;
     
     indent();
-    output << decl->getVarType() << " " << decl->getName();
+    output << text(decl->getVarType()) << " " << text(decl->getName());
     
     if (decl->getInitializer()) {
         output << " = ";
@@ -152,7 +153,7 @@ void CodeGenerator::generateAssign(AssignNode* assign) {
     if (!assign) return;
     
     indent();
-    output << assign->getName() << " = ";
+    output << text(assign->getName()) << " = ";
     generateExpression(assign->getValue());
     output << ";";
     newline();
@@ -215,9 +216,9 @@ void CodeGenerator::generateFor(ForNode* forNode) {
     
     if (forNode->getInit()) {
         // Generate init statement without semicolon
-        VarDeclNode* varDecl = dynamic_cast<VarDeclNode*>(forNode->getInit());
-        if (varDecl) {
-            output << varDecl->getVarType() << " " << varDecl->getName();
+        if (forNode->getInit()->getType() == ASTNode::NODE_VAR_DECL) {
+            VarDeclNode* varDecl = static_cast<VarDeclNode*>(forNode->getInit());
+            output << text(varDecl->getVarType()) << " " << text(varDecl->getName());
             if (varDecl->getInitializer()) {
                 output << " = ";
                 generateExpression(varDecl->getInitializer());
@@ -263,8 +264,8 @@ void CodeGenerator::generateBlock(BlockNode* block) {
     newline();
     indentLevel++;
     
-    for (auto& stmt : block->getStatements()) {
-        generateStatement(stmt.get());
+    for (StatementNode* stmt : block->getStatements()) {
+        generateStatement(stmt);
     }
     
     indentLevel--;
@@ -305,11 +306,11 @@ void CodeGenerator::generateContinue(ContinueNode* continueNode) {
 void CodeGenerator::generateCall(CallNode* call) {
     if (!call) return;
     
-    output << call->getName() << "(";
+    output << text(call->getName()) << "(";
     
     const auto& args = call->getArgs();
     for (size_t i = 0; i < args.size(); i++) {
-        generateExpression(args[i].get());
+        generateExpression(args[i]);
         if (i < args.size() - 1) {
             output << ", ";
         }
@@ -8,11 +8,14 @@
 class CodeGenerator {
 public:
     CodeGenerator();
-    std::string generate(std::vector<std::unique_ptr<StatementNode>>& ast);
+    std::string generate(const TranslationUnit& unit);
     
 private:
     std::ostringstream output;
     int indentLevel;
+    const StringInterner* names;
+    
+    std::string_view text(SymbolId id) const { return names->text(id); }
     
     void generateStatement(StatementNode* stmt);
     void generateExpression(ExpressionNode* expr);
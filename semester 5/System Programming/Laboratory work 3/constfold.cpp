@@ -0,0 +1,351 @@
+#include "constfold.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Folded int results must fit a C int. INT_MIN is excluded too: spelled
+// "-2147483648" it would read back as the negation of a long.
+static bool makeInt(int64_t value, Constant& result) {
+    if (value <= INT32_MIN || value > INT32_MAX) {
+        return false;
+    }
+    result = Constant{false, value, 0.0};
+    return true;
+}
+
+static bool makeFloat(double value, Constant& result) {
+    if (!std::isfinite(value)) {
+        return false;
+    }
+    result = Constant{true, 0, value};
+    return true;
+}
+
+// Shortest spelling that reads back as the same double, always with a
+// fraction so it stays a float literal: 3 becomes "3.0", 1e+20 "1.0e+20"
+static std::string spellFloat(double value) {
+    char buffer[32];
+    for (int precision = 1; precision <= 17; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (std::strtod(buffer, nullptr) == value) {
+            break;
+        }
+    }
+
+    std::string spelling = buffer;
+    if (spelling.find('.') == std::string::npos) {
+        size_t exponent = spelling.find('e');
+        spelling.insert(exponent == std::string::npos ? spelling.size() : exponent, ".0");
+    }
+    return spelling;
+}
+
+// Converts value the way storing it in a variable of the declared type does
+static bool convert(const Constant& value, bool toFloat, Constant& result) {
+    if (toFloat) {
+        return makeFloat(value.asFloat(), result);
+    }
+    if (!value.isFloat) {
+        result = value;
+        return true;
+    }
+    // Out of range float to int conversion is undefined; leave it alone
+    if (!(value.floatValue > INT32_MIN && value.floatValue < INT32_MAX + 1.0)) {
+        return false;
+    }
+    return makeInt(static_cast<int64_t>(value.floatValue), result);
+}
+
+static bool evaluateBinary(Operator op, const Constant& l, const Constant& r, Constant& result) {
+    bool isFloat = l.isFloat || r.isFloat;
+    double a = l.asFloat();
+    double b = r.asFloat();
+
+    switch (op) {
+        case Operator::ADD:
+            return isFloat ? makeFloat(a + b, result) : makeInt(l.intValue + r.intValue, result);
+        case Operator::SUB:
+            return isFloat ? makeFloat(a - b, result) : makeInt(l.intValue - r.intValue, result);
+        case Operator::MUL:
+            return isFloat ? makeFloat(a * b, result) : makeInt(l.intValue * r.intValue, result);
+        case Operator::DIV:
+            // Division by zero is left for the program to trip over
+            if (isFloat) {
+                return b != 0.0 && makeFloat(a / b, result);
+            }
+            return r.intValue != 0 && makeInt(l.intValue / r.intValue, result);
+        case Operator::MOD:
+            if (isFloat || r.intValue == 0) {
+                return false;
+            }
+            return makeInt(l.intValue % r.intValue, result);
+        case Operator::EQ:
+            return makeInt(isFloat ? a == b : l.intValue == r.intValue, result);
+        case Operator::NE:
+            return makeInt(isFloat ? a != b : l.intValue != r.intValue, result);
+        case Operator::LT:
+            return makeInt(isFloat ? a < b : l.intValue < r.intValue, result);
+        case Operator::GT:
+            return makeInt(isFloat ? a > b : l.intValue > r.intValue, result);
+        case Operator::LE:
+            return makeInt(isFloat ? a <= b : l.intValue <= r.intValue, result);
+        case Operator::GE:
+            return makeInt(isFloat ? a >= b : l.intValue >= r.intValue, result);
+        case Operator::AND:
+            return makeInt(l.isTrue() && r.isTrue(), result);
+        case Operator::OR:
+            return makeInt(l.isTrue() || r.isTrue(), result);
+        default:
+            return false;
+    }
+}
+
+static bool evaluateUnary(Operator op, const Constant& operand, Constant& result) {
+    switch (op) {
+        case Operator::NEG:
+            return operand.isFloat ? makeFloat(-operand.floatValue, result)
+                                   : makeInt(-operand.intValue, result);
+        case Operator::PLUS:
+            result = operand;
+            return true;
+        case Operator::NOT:
+            return makeInt(!operand.isTrue(), result);
+        default:
+            return false;
+    }
+}
+
+bool constantValue(const ExpressionNode* expr, const StringInterner& names, Constant& value) {
+    if (!expr || expr->getType() != ASTNode::NODE_LITERAL) {
+        return false;
+    }
+
+    const LiteralNode* lit = static_cast<const LiteralNode*>(expr);
+    // Interned text is NUL-terminated
+    const char* spelling = names.text(lit->getValue()).data();
+    if (lit->getResolvedType() == TypeId::INT) {
+        value = Constant{false, std::strtoll(spelling, nullptr, 10), 0.0};
+        return true;
+    }
+    if (lit->getResolvedType() == TypeId::DOUBLE) {
+        value = Constant{true, 0, std::strtod(spelling, nullptr)};
+        return true;
+    }
+    return false;
+}
+
+ConstantFolder::ConstantFolder()
+    : arena(nullptr), names(nullptr), tracking(false), foldedCount(0), propagatedCount(0) {}
+
+void ConstantFolder::fold(TranslationUnit& unit) {
+    arena = &unit.getArena();
+    names = &unit.getNames();
+    bindings.clear();
+    bound.clear();
+    tracking = false;
+    foldedCount = 0;
+    propagatedCount = 0;
+
+    // Top-level declarations are globals that any call may change, so only
+    // function bodies propagate
+    for (StatementNode* stmt : unit.getStatements()) {
+        foldStatement(stmt);
+    }
+}
+
+void ConstantFolder::foldStatement(StatementNode* stmt) {
+    if (!stmt) return;
+
+    // A compound statement ends the straight-line run: everything known
+    // before it is forgotten and its blocks start from nothing
+    switch (stmt->getType()) {
+        case ASTNode::NODE_FUNCTION: {
+            FunctionNode* func = static_cast<FunctionNode*>(stmt);
+            forgetAll();
+            tracking = true;
+            foldBlock(func->getBody());
+            forgetAll();
+            tracking = false;
+            break;
+        }
+        case ASTNode::NODE_VAR_DECL: {
+            VarDeclNode* decl = static_cast<VarDeclNode*>(stmt);
+            decl->setInitializer(foldExpression(decl->getInitializer()));
+            declare(decl->getName(), decl->getVarType(), decl->getInitializer());
+            break;
+        }
+        case ASTNode::NODE_ASSIGN: {
+            AssignNode* assignNode = static_cast<AssignNode*>(stmt);
+            assignNode->setValue(foldExpression(assignNode->getValue()));
+            assign(assignNode->getName(), assignNode->getValue());
+            break;
+        }
+        case ASTNode::NODE_IF: {
+            // The condition still runs in the current block
+            IfNode* ifNode = static_cast<IfNode*>(stmt);
+            ifNode->setCondition(foldExpression(ifNode->getCondition()));
+            forgetAll();
+            foldBlock(ifNode->getThenBlock());
+            forgetAll();
+            foldBlock(ifNode->getElseBlock());
+            forgetAll();
+            break;
+        }
+        case ASTNode::NODE_WHILE: {
+            // The condition is evaluated again after every iteration
+            WhileNode* whileNode = static_cast<WhileNode*>(stmt);
+            forgetAll();
+            whileNode->setCondition(foldExpression(whileNode->getCondition()));
+            foldBlock(whileNode->getBody());
+            forgetAll();
+            break;
+        }
+        case ASTNode::NODE_FOR: {
+            ForNode* forNode = static_cast<ForNode*>(stmt);
+            foldStatement(forNode->getInit());
+            forgetAll();
+            forNode->setCondition(foldExpression(forNode->getCondition()));
+            forNode->setIncrement(foldExpression(forNode->getIncrement()));
+            foldBlock(forNode->getBody());
+            forgetAll();
+            break;
+        }
+        case ASTNode::NODE_BLOCK:
+            forgetAll();
+            foldBlock(static_cast<BlockNode*>(stmt));
+            forgetAll();
+            break;
+        case ASTNode::NODE_RETURN: {
+            ReturnNode* returnNode = static_cast<ReturnNode*>(stmt);
+            returnNode->setValue(foldExpression(returnNode->getValue()));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ConstantFolder::foldBlock(BlockNode* block) {
+    if (!block) return;
+
+    for (StatementNode* stmt : block->getStatements()) {
+        foldStatement(stmt);
+    }
+}
+
+ExpressionNode* ConstantFolder::foldExpression(ExpressionNode* expr) {
+    if (!expr) return nullptr;
+
+    switch (expr->getType()) {
+        case ASTNode::NODE_BINARY_OP:
+            return foldBinary(static_cast<BinaryOpNode*>(expr));
+        case ASTNode::NODE_UNARY_OP:
+            return foldUnary(static_cast<UnaryOpNode*>(expr));
+        case ASTNode::NODE_IDENTIFIER: {
+            IdentifierNode* id = static_cast<IdentifierNode*>(expr);
+            SymbolId name = id->getName();
+            if (name < bindings.size() && bindings[name].state == Binding::KNOWN) {
+                propagatedCount++;
+                return makeLiteral(bindings[name].value, id->getLine());
+            }
+            return expr;
+        }
+        case ASTNode::NODE_CALL: {
+            for (ExpressionNode*& arg : static_cast<CallNode*>(expr)->getArgs()) {
+                arg = foldExpression(arg);
+            }
+            return expr;
+        }
+        default:
+            return expr;
+    }
+}
+
+ExpressionNode* ConstantFolder::foldBinary(BinaryOpNode* binary) {
+    if (binary->getOp() == Operator::ASSIGN) {
+        // The target is written, not read; it is unknown from here on
+        binary->setRight(foldExpression(binary->getRight()));
+        ExpressionNode* target = binary->getLeft();
+        if (target && target->getType() == ASTNode::NODE_IDENTIFIER) {
+            assign(static_cast<IdentifierNode*>(target)->getName(), nullptr);
+        } else {
+            binary->setLeft(foldExpression(target));
+        }
+        return binary;
+    }
+
+    binary->setLeft(foldExpression(binary->getLeft()));
+    binary->setRight(foldExpression(binary->getRight()));
+
+    Constant left, right, result;
+    if (!constantValue(binary->getLeft(), *names, left) ||
+        !constantValue(binary->getRight(), *names, right) ||
+        !evaluateBinary(binary->getOp(), left, right, result)) {
+        return binary;
+    }
+    foldedCount++;
+    return makeLiteral(result, binary->getLine());
+}
+
+ExpressionNode* ConstantFolder::foldUnary(UnaryOpNode* unary) {
+    unary->setOperand(foldExpression(unary->getOperand()));
+
+    Constant operand, result;
+    if (!constantValue(unary->getOperand(), *names, operand) ||
+        !evaluateUnary(unary->getOp(), operand, result)) {
+        return unary;
+    }
+    foldedCount++;
+    return makeLiteral(result, unary->getLine());
+}
+
+LiteralNode* ConstantFolder::makeLiteral(const Constant& value, int line) {
+    if (value.isFloat) {
+        return arena->make<LiteralNode>(names->intern(spellFloat(value.floatValue)), "float", line);
+    }
+    return arena->make<LiteralNode>(names->intern(std::to_string(value.intValue)), "int", line);
+}
+
+void ConstantFolder::declare(SymbolId name, SymbolId type, ExpressionNode* initializer) {
+    if (!tracking) return;
+
+    if (name >= bindings.size()) {
+        bindings.resize(name + 1, Binding{Binding::UNTRACKED, false, Constant{false, 0, 0.0}});
+    }
+    // Only int and double locals are followed; a float or char would need
+    // its own rounding
+    Binding& binding = bindings[name];
+    TypeId declared = typeFromName(names->text(type));
+    if (declared != TypeId::INT && declared != TypeId::DOUBLE) {
+        binding.state = Binding::UNTRACKED;
+        return;
+    }
+    if (binding.state == Binding::UNTRACKED) {
+        bound.push_back(name);
+    }
+    binding.isFloat = declared == TypeId::DOUBLE;
+    binding.state = Binding::UNKNOWN;
+    assign(name, initializer);
+}
+
+void ConstantFolder::assign(SymbolId name, ExpressionNode* value) {
+    if (name >= bindings.size() || bindings[name].state == Binding::UNTRACKED) {
+        return;
+    }
+
+    Binding& binding = bindings[name];
+    Constant constant;
+    if (constantValue(value, *names, constant) && convert(constant, binding.isFloat, binding.value)) {
+        binding.state = Binding::KNOWN;
+    } else {
+        binding.state = Binding::UNKNOWN;
+    }
+}
+
+void ConstantFolder::forgetAll() {
+    for (SymbolId name : bound) {
+        bindings[name].state = Binding::UNTRACKED;
+    }
+    bound.clear();
+}
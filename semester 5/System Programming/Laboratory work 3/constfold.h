@@ -0,0 +1,66 @@
+#ifndef CONSTFOLD_H
+#define CONSTFOLD_H
+
+#include "ast.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Value of an int or float literal. Int values always fit in a C int.
+struct Constant {
+    bool isFloat;
+    int64_t intValue;
+    double floatValue;
+
+    double asFloat() const { return isFloat ? floatValue : static_cast<double>(intValue); }
+    bool isTrue() const { return isFloat ? floatValue != 0.0 : intValue != 0; }
+};
+
+// Reads expr if it is an int or float literal; strings, chars and every
+// other node give false
+bool constantValue(const ExpressionNode* expr, const StringInterner& names, Constant& value);
+
+// Rewrites the tree in place so that operators over int and float literals
+// become a single literal, and a local int or double variable assigned a
+// constant is replaced by that constant in the straight-line statements that
+// follow, up to the next assignment or compound statement. New literals are
+// allocated from the unit's arena and spelled in its string table, so every
+// later stage sees them like parsed ones.
+class ConstantFolder {
+public:
+    ConstantFolder();
+    void fold(TranslationUnit& unit);
+
+    size_t getFoldedCount() const { return foldedCount; }
+    size_t getPropagatedCount() const { return propagatedCount; }
+
+private:
+    // What is known about a variable declared in the block being folded
+    struct Binding {
+        enum State : uint8_t { UNTRACKED, UNKNOWN, KNOWN };
+        State state;
+        bool isFloat;               // Declared double rather than int
+        Constant value;             // Valid when state is KNOWN
+    };
+
+    Arena* arena;
+    StringInterner* names;
+    std::vector<Binding> bindings;  // Indexed by SymbolId
+    std::vector<SymbolId> bound;    // Names with a binding, for forgetAll()
+    bool tracking;                  // Inside a function body
+    size_t foldedCount;
+    size_t propagatedCount;
+
+    void foldStatement(StatementNode* stmt);
+    void foldBlock(BlockNode* block);
+    ExpressionNode* foldExpression(ExpressionNode* expr);
+    ExpressionNode* foldBinary(BinaryOpNode* binary);
+    ExpressionNode* foldUnary(UnaryOpNode* unary);
+    LiteralNode* makeLiteral(const Constant& value, int line);
+
+    void declare(SymbolId name, SymbolId type, ExpressionNode* initializer);
+    void assign(SymbolId name, ExpressionNode* value);
+    void forgetAll();
+};
+
+#endif // CONSTFOLD_H
@@ -0,0 +1,288 @@
+#include "dce.h"
+#include "constfold.h"
+#include <algorithm>
+#include <utility>
+
+// True when evaluating expr can only produce a value: no call and no
+// assignment anywhere inside it
+static bool isPure(const ExpressionNode* expr) {
+    if (!expr) return true;
+
+    switch (expr->getType()) {
+        case ASTNode::NODE_BINARY_OP: {
+            const BinaryOpNode* binary = static_cast<const BinaryOpNode*>(expr);
+            return binary->getOp() != Operator::ASSIGN &&
+                   isPure(binary->getLeft()) && isPure(binary->getRight());
+        }
+        case ASTNode::NODE_UNARY_OP:
+            return isPure(static_cast<const UnaryOpNode*>(expr)->getOperand());
+        case ASTNode::NODE_CALL:
+            return false;
+        default:
+            return true;
+    }
+}
+
+DeadCodeEliminator::DeadCodeEliminator()
+    : names(nullptr), initializerOwner(NONE), unreachableCount(0), branchCount(0),
+      loopCount(0), variableCount(0) {}
+
+void DeadCodeEliminator::eliminate(TranslationUnit& unit) {
+    names = &unit.getNames();
+    unreachableCount = 0;
+    branchCount = 0;
+    loopCount = 0;
+    variableCount = 0;
+
+    for (StatementNode* stmt : unit.getStatements()) {
+        if (stmt && stmt->getType() == ASTNode::NODE_FUNCTION) {
+            FunctionNode* func = static_cast<FunctionNode*>(stmt);
+            pruneBlock(func->getBody());
+            removeUnusedLocals(func);
+        }
+    }
+}
+
+bool DeadCodeEliminator::pruneBlock(BlockNode* block) {
+    if (!block) return false;
+
+    ArenaSpan<StatementNode*>& statements = block->getStatements();
+    size_t kept = 0;
+    bool jumps = false;
+    for (size_t i = 0; i < statements.size(); i++) {
+        if (jumps) {
+            // Empty slots are expression statements the parser dropped
+            if (statements[i]) {
+                unreachableCount++;
+            }
+            continue;
+        }
+
+        bool removed = false;
+        StatementNode* stmt = pruneStatement(statements[i], removed, jumps);
+        if (!removed) {
+            statements[kept++] = stmt;
+        }
+    }
+    statements.truncate(kept);
+    return jumps;
+}
+
+StatementNode* DeadCodeEliminator::pruneStatement(StatementNode* stmt, bool& removed, bool& jumps) {
+    if (!stmt) return nullptr;
+
+    switch (stmt->getType()) {
+        case ASTNode::NODE_RETURN:
+        case ASTNode::NODE_BREAK:
+        case ASTNode::NODE_CONTINUE:
+            jumps = true;
+            break;
+        case ASTNode::NODE_BLOCK:
+            jumps = pruneBlock(static_cast<BlockNode*>(stmt));
+            break;
+        case ASTNode::NODE_IF: {
+            IfNode* ifNode = static_cast<IfNode*>(stmt);
+            Constant condition;
+            if (constantValue(ifNode->getCondition(), *names, condition)) {
+                // The branch that runs takes the if's place, still as a
+                // block so its declarations keep their scope
+                BlockNode* taken = condition.isTrue() ? ifNode->getThenBlock() : ifNode->getElseBlock();
+                BlockNode* dropped = condition.isTrue() ? ifNode->getElseBlock() : ifNode->getThenBlock();
+                if (dropped) {
+                    branchCount++;
+                }
+                if (!taken) {
+                    removed = true;
+                    return nullptr;
+                }
+                jumps = pruneBlock(taken);
+                return taken;
+            }
+            bool thenJumps = pruneBlock(ifNode->getThenBlock());
+            bool elseJumps = pruneBlock(ifNode->getElseBlock());
+            jumps = thenJumps && elseJumps && ifNode->getElseBlock();
+            break;
+        }
+        case ASTNode::NODE_WHILE: {
+            WhileNode* whileNode = static_cast<WhileNode*>(stmt);
+            Constant condition;
+            if (constantValue(whileNode->getCondition(), *names, condition) && !condition.isTrue()) {
+                loopCount++;
+                removed = true;
+                return nullptr;
+            }
+            pruneBlock(whileNode->getBody());
+            break;
+        }
+        case ASTNode::NODE_FOR:
+            pruneBlock(static_cast<ForNode*>(stmt)->getBody());
+            break;
+        default:
+            break;
+    }
+    return stmt;
+}
+
+void DeadCodeEliminator::removeUnusedLocals(FunctionNode* func) {
+    locals.clear();
+    initializerReads.clear();
+    initializerOwner = NONE;
+    scopes.reset(names->size());
+
+    collectBlock(func->getBody());
+
+    // Removing a variable drops the references its initializer made, which
+    // may leave other variables unused in turn
+    std::vector<uint32_t> worklist;
+    for (uint32_t i = 0; i < locals.size(); i++) {
+        if (locals[i].uses == 0 && locals[i].removable) {
+            locals[i].removed = true;
+            worklist.push_back(i);
+        }
+    }
+    std::vector<std::pair<BlockNode*, uint32_t>> removedSlots;
+    while (!worklist.empty()) {
+        const Local& local = locals[worklist.back()];
+        worklist.pop_back();
+        removedSlots.emplace_back(local.block, local.index);
+
+        for (uint32_t r = local.readsBegin; r < local.readsEnd; r++) {
+            Local& read = locals[initializerReads[r]];
+            if (--read.uses == 0 && read.removable && !read.removed) {
+                read.removed = true;
+                worklist.push_back(initializerReads[r]);
+            }
+        }
+    }
+    variableCount += removedSlots.size();
+
+    // Compact each block once, dropping its removed slots in order
+    std::sort(removedSlots.begin(), removedSlots.end());
+    for (size_t i = 0; i < removedSlots.size();) {
+        BlockNode* block = removedSlots[i].first;
+        ArenaSpan<StatementNode*>& statements = block->getStatements();
+        size_t kept = 0;
+        for (uint32_t s = 0; s < statements.size(); s++) {
+            if (i < removedSlots.size() && removedSlots[i].first == block && removedSlots[i].second == s) {
+                i++;
+                continue;
+            }
+            statements[kept++] = statements[s];
+        }
+        statements.truncate(kept);
+    }
+}
+
+void DeadCodeEliminator::collectBlock(BlockNode* block) {
+    if (!block) return;
+
+    scopes.enterScope();
+    const ArenaSpan<StatementNode*>& statements = block->getStatements();
+    for (uint32_t i = 0; i < statements.size(); i++) {
+        collectStatement(statements[i], block, i);
+    }
+    scopes.exitScope();
+}
+
+void DeadCodeEliminator::collectStatement(StatementNode* stmt, BlockNode* block, uint32_t index) {
+    if (!stmt) return;
+
+    switch (stmt->getType()) {
+        case ASTNode::NODE_VAR_DECL: {
+            VarDeclNode* decl = static_cast<VarDeclNode*>(stmt);
+            uint32_t id = static_cast<uint32_t>(locals.size());
+            uint32_t readsBegin = static_cast<uint32_t>(initializerReads.size());
+            locals.push_back(Local{block, index, 0, readsBegin, readsBegin,
+                                   block && isPure(decl->getInitializer()), false});
+
+            // The initializer is walked before the name is declared, so
+            // "int x = x;" reads an outer x
+            initializerOwner = id;
+            collectExpression(decl->getInitializer());
+            initializerOwner = NONE;
+            locals[id].readsEnd = static_cast<uint32_t>(initializerReads.size());
+
+            scopes.declare(decl->getName(), id);
+            break;
+        }
+        case ASTNode::NODE_ASSIGN: {
+            AssignNode* assignNode = static_cast<AssignNode*>(stmt);
+            reference(assignNode->getName());
+            collectExpression(assignNode->getValue());
+            break;
+        }
+        case ASTNode::NODE_IF: {
+            IfNode* ifNode = static_cast<IfNode*>(stmt);
+            collectExpression(ifNode->getCondition());
+            collectBlock(ifNode->getThenBlock());
+            collectBlock(ifNode->getElseBlock());
+            break;
+        }
+        case ASTNode::NODE_WHILE: {
+            WhileNode* whileNode = static_cast<WhileNode*>(stmt);
+            collectExpression(whileNode->getCondition());
+            collectBlock(whileNode->getBody());
+            break;
+        }
+        case ASTNode::NODE_FOR: {
+            // A declaration in the init is not in a block and is never removed
+            ForNode* forNode = static_cast<ForNode*>(stmt);
+            scopes.enterScope();
+            collectStatement(forNode->getInit(), nullptr, 0);
+            collectExpression(forNode->getCondition());
+            collectExpression(forNode->getIncrement());
+            collectBlock(forNode->getBody());
+            scopes.exitScope();
+            break;
+        }
+        case ASTNode::NODE_BLOCK:
+            collectBlock(static_cast<BlockNode*>(stmt));
+            break;
+        case ASTNode::NODE_RETURN:
+            collectExpression(static_cast<ReturnNode*>(stmt)->getValue());
+            break;
+        default:
+            break;
+    }
+}
+
+void DeadCodeEliminator::collectExpression(ExpressionNode* expr) {
+    if (!expr) return;
+
+    switch (expr->getType()) {
+        case ASTNode::NODE_BINARY_OP: {
+            BinaryOpNode* binary = static_cast<BinaryOpNode*>(expr);
+            collectExpression(binary->getLeft());
+            collectExpression(binary->getRight());
+            break;
+        }
+        case ASTNode::NODE_UNARY_OP:
+            collectExpression(static_cast<UnaryOpNode*>(expr)->getOperand());
+            break;
+        case ASTNode::NODE_IDENTIFIER:
+            reference(static_cast<IdentifierNode*>(expr)->getName());
+            break;
+        case ASTNode::NODE_CALL:
+            for (ExpressionNode* arg : static_cast<CallNode*>(expr)->getArgs()) {
+                collectExpression(arg);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Any mention keeps a declaration, writes included: without it the
+// assignment would name an undeclared or outer variable
+void DeadCodeEliminator::reference(SymbolId name) {
+    const uint32_t* found = scopes.find(name);
+    if (!found) {
+        return;
+    }
+
+    uint32_t id = *found;
+    locals[id].uses++;
+    if (initializerOwner != NONE) {
+        initializerReads.push_back(id);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef DCE_H
+#define DCE_H
+
+#include "ast.h"
+#include "scoped_names.h"
+#include <cstdint>
+#include <vector>
+
+// Removes code from function bodies that can never run or whose result is
+// never read:
+//   - statements after a return, break or continue in the same block, or
+//     after a nested block or if whose every path ends in one
+//   - the branch of an if whose condition is a constant, keeping the other
+//   - while loops whose condition is a constant false
+//   - local variables that are never referenced and whose initializer has
+//     no side effects, including ones only read by other removed variables
+// Conditions are recognized only as literals, so ConstantFolder should run
+// first.
+class DeadCodeEliminator {
+public:
+    DeadCodeEliminator();
+    void eliminate(TranslationUnit& unit);
+
+    size_t getUnreachableCount() const { return unreachableCount; }
+    size_t getBranchCount() const { return branchCount; }
+    size_t getLoopCount() const { return loopCount; }
+    size_t getVariableCount() const { return variableCount; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // A local declaration of the function being cleaned up
+    struct Local {
+        BlockNode* block;           // Block holding the declaration, or null
+        uint32_t index;             // Its position in the block
+        uint32_t uses;              // References not yet removed
+        uint32_t readsBegin;        // Range of initializerReads
+        uint32_t readsEnd;
+        bool removable;             // In a block, with a pure initializer
+        bool removed;
+    };
+
+    const StringInterner* names;
+    std::vector<Local> locals;
+    std::vector<uint32_t> initializerReads;  // Locals each initializer refers to
+    uint32_t initializerOwner;      // Local whose initializer is being walked
+
+    ScopedNames<uint32_t> scopes;   // Index into locals of each name in scope
+
+    size_t unreachableCount;
+    size_t branchCount;
+    size_t loopCount;
+    size_t variableCount;
+
+    // Unreachable code and constant conditions; pruneBlock() returns true
+    // when control never reaches the end of the block
+    bool pruneBlock(BlockNode* block);
+    StatementNode* pruneStatement(StatementNode* stmt, bool& removed, bool& jumps);
+
+    // Unused locals
+    void removeUnusedLocals(FunctionNode* func);
+    void collectBlock(BlockNode* block);
+    void collectStatement(StatementNode* stmt, BlockNode* block, uint32_t index);
+    void collectExpression(ExpressionNode* expr);
+    void reference(SymbolId name);
+};
+
+#endif // DCE_H
@@ -0,0 +1,18 @@
+#include "driver.h"
+#include <iostream>
+#include "parser.tab.hh"
+
+bool parseFile(FILE* file, TranslationUnit& unit) {
+    yyscan_t scanner;
+    if (yylex_init_extra(&unit, &scanner) != 0) {
+        std::cerr << "Error: Cannot create scanner" << std::endl;
+        return false;
+    }
+    yyset_in(file, scanner);
+
+    yy::parser parser(scanner, unit);
+    int result = parser.parse();
+
+    yylex_destroy(scanner);
+    return result == 0;
+}
@@ -0,0 +1,12 @@
+#ifndef DRIVER_H
+#define DRIVER_H
+
+#include <cstdio>
+#include "ast.h"
+
+// Parses an open source file into 'unit'. Every call gets a scanner and a
+// parser of its own, so different units can be parsed on different threads
+// at once. Syntax errors are reported on std::cerr.
+bool parseFile(FILE* file, TranslationUnit& unit);
+
+#endif // DRIVER_H
@@ -0,0 +1,56 @@
+#include "interner.h"
+
+static const size_t INITIAL_SLOTS = 1024;
+
+static uint32_t hashText(std::string_view text) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+StringInterner::StringInterner() : slots(INITIAL_SLOTS, 0) {}
+
+SymbolId StringInterner::intern(std::string_view text) {
+    uint32_t hash = hashText(text);
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint32_t slot = slots[i];
+        if (slot == 0) {
+            SymbolId id = static_cast<SymbolId>(strings.size());
+            strings.push_back(storage.copyString(text));
+            hashes.push_back(hash);
+            slots[i] = id + 1;
+            // Keep the load factor at or below one half
+            if (strings.size() * 2 > slots.size()) {
+                grow();
+            }
+            return id;
+        }
+        if (hashes[slot - 1] == hash && strings[slot - 1] == text) {
+            return slot - 1;
+        }
+    }
+}
+
+void StringInterner::grow() {
+    std::vector<uint32_t> larger(slots.size() * 2, 0);
+    size_t mask = larger.size() - 1;
+    for (SymbolId id = 0; id < strings.size(); id++) {
+        size_t i = hashes[id] & mask;
+        while (larger[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        larger[i] = id + 1;
+    }
+    slots.swap(larger);
+}
+
+void StringInterner::clear() {
+    strings.clear();
+    hashes.clear();
+    slots.assign(INITIAL_SLOTS, 0);
+    storage.reset();
+}
@@ -0,0 +1,38 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "arena.h"
+
+// Dense id of an interned string; equal ids mean equal text
+using SymbolId = uint32_t;
+
+// Maps every distinct identifier, type name and literal spelling of a
+// translation unit to a SymbolId. Each text is stored once, NUL-terminated,
+// in the interner's own arena, so AST nodes keep a 4-byte id instead of a
+// copy of the string.
+class StringInterner {
+public:
+    StringInterner();
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    SymbolId intern(std::string_view text);
+    std::string_view text(SymbolId id) const { return strings[id]; }
+    size_t size() const { return strings.size(); }
+
+    void clear();
+
+private:
+    Arena storage;
+    std::vector<std::string_view> strings;  // Indexed by id
+    std::vector<uint32_t> hashes;           // Indexed by id, kept for rehashing
+    std::vector<uint32_t> slots;            // Open addressing: id + 1, 0 when empty
+
+    void grow();
+};
+
+#endif // INTERNER_H
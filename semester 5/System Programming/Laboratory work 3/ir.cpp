@@ -0,0 +1,598 @@
+#include "ir.h"
+#include "scoped_names.h"
+#include <algorithm>
+#include <charconv>
+#include <string>
+#include <string_view>
+
+namespace ir {
+
+namespace {
+
+const uint32_t NONE = UINT32_MAX;
+
+Operand none() { return Operand{Operand::NONE, 0}; }
+Operand immediate(uint32_t value) { return Operand{Operand::IMMEDIATE, value}; }
+
+// Lowers one function. Blocks are filled one at a time and never reopened,
+// so each one is a contiguous run of instructions. Code that follows a
+// return, break or continue starts a new block without predecessors.
+class Lowerer {
+public:
+    explicit Lowerer(Function& function) : function(function), current(NONE) {}
+
+    void lowerFunction(const FunctionNode* func);
+
+private:
+    // A block while lowering; numbered in creation order until finish()
+    struct Block {
+        uint32_t first;
+        uint32_t count;
+        uint32_t targets[2];
+        uint32_t targetCount;
+    };
+
+    struct Loop {
+        uint32_t breakTarget;
+        uint32_t continueTarget;
+    };
+
+    Function& function;
+    std::vector<Block> blocks;
+    uint32_t current;               // Block being filled, NONE after a terminator
+    std::vector<Loop> loops;
+
+    ScopedNames<uint32_t> variables;    // Index into function.variables
+
+    uint32_t newBlock();
+    void startBlock(uint32_t block);
+    void emit(Opcode opcode, Operand dst, Operand a = none(), Operand b = none(),
+              Operator op = Operator::ADD);
+    void terminate(Opcode opcode, Operand a, uint32_t target0 = NONE, uint32_t target1 = NONE);
+    void jump(uint32_t target);
+    Operand newTemp();
+    void finish();
+
+    void lowerStatement(const StatementNode* stmt);
+    void lowerBlock(const BlockNode* block);
+    void lowerIf(const IfNode* ifNode);
+    void lowerWhile(const WhileNode* whileNode);
+    void lowerFor(const ForNode* forNode);
+    Operand lowerExpression(const ExpressionNode* expr);
+    Operand lowerLogical(const BinaryOpNode* binary);
+    Operand lowerCall(const CallNode* call);
+
+    uint32_t declare(SymbolId name, SymbolId type);
+    Operand resolve(SymbolId name) const;
+};
+
+void Lowerer::lowerFunction(const FunctionNode* func) {
+    function.name = func->getName();
+    function.returnType = func->getReturnType();
+    function.tempCount = 0;
+
+    variables.enterScope();
+    for (const Parameter& param : func->getParams()) {
+        declare(param.name, param.type);
+    }
+    function.parameterCount = static_cast<uint32_t>(function.variables.size());
+
+    startBlock(newBlock());
+    lowerBlock(func->getBody());
+    // Falling off the end returns
+    if (current != NONE) {
+        terminate(Opcode::RETURN, none());
+    }
+    variables.exitScope();
+
+    finish();
+}
+
+uint32_t Lowerer::newBlock() {
+    blocks.push_back(Block{NONE, 0, {NONE, NONE}, 0});
+    return static_cast<uint32_t>(blocks.size() - 1);
+}
+
+void Lowerer::startBlock(uint32_t block) {
+    // The block being filled falls through into the new one
+    if (current != NONE) {
+        jump(block);
+    }
+    blocks[block].first = static_cast<uint32_t>(function.instructions.size());
+    current = block;
+}
+
+void Lowerer::emit(Opcode opcode, Operand dst, Operand a, Operand b, Operator op) {
+    // Unreachable code still gets a block of its own
+    if (current == NONE) {
+        startBlock(newBlock());
+    }
+    function.instructions.push_back(Instruction{opcode, op, dst, a, b});
+    blocks[current].count++;
+}
+
+void Lowerer::terminate(Opcode opcode, Operand a, uint32_t target0, uint32_t target1) {
+    emit(opcode, none(), a);
+    Block& block = blocks[current];
+    for (uint32_t target : {target0, target1}) {
+        if (target != NONE) {
+            block.targets[block.targetCount++] = target;
+        }
+    }
+    current = NONE;
+}
+
+// An implicit jump from unreachable code is not emitted
+void Lowerer::jump(uint32_t target) {
+    if (current != NONE) {
+        terminate(Opcode::JUMP, none(), target);
+    }
+}
+
+Operand Lowerer::newTemp() {
+    return Operand{Operand::TEMP, function.tempCount++};
+}
+
+// Renumbers blocks in layout order and builds the edge lists
+void Lowerer::finish() {
+    std::vector<uint32_t> order(blocks.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return blocks[a].first < blocks[b].first;
+    });
+    std::vector<uint32_t> number(blocks.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        number[order[i]] = i;
+    }
+
+    function.blocks.resize(blocks.size());
+    std::vector<uint32_t> predecessorCounts(blocks.size(), 0);
+    for (uint32_t i = 0; i < order.size(); i++) {
+        const Block& block = blocks[order[i]];
+        BasicBlock& out = function.blocks[i];
+        out.first = block.first;
+        out.count = block.count;
+        out.successors = static_cast<uint32_t>(function.edges.size());
+        out.successorCount = block.targetCount;
+        for (uint32_t t = 0; t < block.targetCount; t++) {
+            uint32_t target = number[block.targets[t]];
+            function.edges.push_back(target);
+            predecessorCounts[target]++;
+        }
+    }
+
+    // Predecessor ranges follow the successor ranges, in block order
+    uint32_t next = static_cast<uint32_t>(function.edges.size());
+    for (uint32_t i = 0; i < function.blocks.size(); i++) {
+        function.blocks[i].predecessors = next;
+        function.blocks[i].predecessorCount = 0;
+        next += predecessorCounts[i];
+    }
+    function.edges.resize(next);
+    for (uint32_t i = 0; i < function.blocks.size(); i++) {
+        const BasicBlock& block = function.blocks[i];
+        for (uint32_t s = 0; s < block.successorCount; s++) {
+            BasicBlock& target = function.blocks[function.edges[block.successors + s]];
+            function.edges[target.predecessors + target.predecessorCount++] = i;
+        }
+    }
+}
+
+void Lowerer::lowerStatement(const StatementNode* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->getType()) {
+        case ASTNode::NODE_VAR_DECL: {
+            // In scope from its own initializer on, as in C
+            const VarDeclNode* decl = static_cast<const VarDeclNode*>(stmt);
+            Operand var{Operand::VAR, declare(decl->getName(), decl->getVarType())};
+            if (decl->getInitializer()) {
+                emit(Opcode::COPY, var, lowerExpression(decl->getInitializer()));
+            }
+            break;
+        }
+        case ASTNode::NODE_ASSIGN: {
+            const AssignNode* assign = static_cast<const AssignNode*>(stmt);
+            Operand value = lowerExpression(assign->getValue());
+            emit(Opcode::COPY, resolve(assign->getName()), value);
+            break;
+        }
+        case ASTNode::NODE_IF:
+            lowerIf(static_cast<const IfNode*>(stmt));
+            break;
+        case ASTNode::NODE_WHILE:
+            lowerWhile(static_cast<const WhileNode*>(stmt));
+            break;
+        case ASTNode::NODE_FOR:
+            lowerFor(static_cast<const ForNode*>(stmt));
+            break;
+        case ASTNode::NODE_BLOCK:
+            lowerBlock(static_cast<const BlockNode*>(stmt));
+            break;
+        case ASTNode::NODE_RETURN: {
+            const ReturnNode* returnNode = static_cast<const ReturnNode*>(stmt);
+            Operand value = returnNode->getValue() ? lowerExpression(returnNode->getValue()) : none();
+            terminate(Opcode::RETURN, value);
+            break;
+        }
+        case ASTNode::NODE_BREAK:
+        case ASTNode::NODE_CONTINUE:
+            // Outside a loop there is nowhere to go; the C compiler reports it
+            if (!loops.empty()) {
+                const Loop& loop = loops.back();
+                bool isBreak = stmt->getType() == ASTNode::NODE_BREAK;
+                terminate(Opcode::JUMP, none(), isBreak ? loop.breakTarget : loop.continueTarget);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Lowerer::lowerBlock(const BlockNode* block) {
+    if (!block) return;
+
+    variables.enterScope();
+    for (const StatementNode* stmt : block->getStatements()) {
+        lowerStatement(stmt);
+    }
+    variables.exitScope();
+}
+
+void Lowerer::lowerIf(const IfNode* ifNode) {
+    Operand condition = lowerExpression(ifNode->getCondition());
+    uint32_t thenBlock = newBlock();
+    uint32_t elseBlock = ifNode->getElseBlock() ? newBlock() : NONE;
+    uint32_t join = newBlock();
+    terminate(Opcode::BRANCH, condition, thenBlock, elseBlock != NONE ? elseBlock : join);
+
+    startBlock(thenBlock);
+    lowerBlock(ifNode->getThenBlock());
+    jump(join);
+    if (elseBlock != NONE) {
+        startBlock(elseBlock);
+        lowerBlock(ifNode->getElseBlock());
+        jump(join);
+    }
+    startBlock(join);
+}
+
+void Lowerer::lowerWhile(const WhileNode* whileNode) {
+    uint32_t header = newBlock();
+    uint32_t body = newBlock();
+    uint32_t exit = newBlock();
+
+    startBlock(header);
+    Operand condition = lowerExpression(whileNode->getCondition());
+    terminate(Opcode::BRANCH, condition, body, exit);
+
+    startBlock(body);
+    loops.push_back(Loop{exit, header});
+    lowerBlock(whileNode->getBody());
+    loops.pop_back();
+    jump(header);
+
+    startBlock(exit);
+}
+
+void Lowerer::lowerFor(const ForNode* forNode) {
+    variables.enterScope();
+    lowerStatement(forNode->getInit());
+
+    uint32_t header = newBlock();
+    uint32_t body = newBlock();
+    uint32_t step = newBlock();
+    uint32_t exit = newBlock();
+
+    // A missing condition loops until a break
+    startBlock(header);
+    if (forNode->getCondition()) {
+        Operand condition = lowerExpression(forNode->getCondition());
+        terminate(Opcode::BRANCH, condition, body, exit);
+    }
+
+    startBlock(body);
+    loops.push_back(Loop{exit, step});
+    lowerBlock(forNode->getBody());
+    loops.pop_back();
+
+    startBlock(step);
+    lowerExpression(forNode->getIncrement());
+    jump(header);
+
+    startBlock(exit);
+    variables.exitScope();
+}
+
+Operand Lowerer::lowerExpression(const ExpressionNode* expr) {
+    if (!expr) return none();
+
+    switch (expr->getType()) {
+        case ASTNode::NODE_LITERAL:
+            return Operand{Operand::CONST, static_cast<const LiteralNode*>(expr)->getValue()};
+        case ASTNode::NODE_IDENTIFIER:
+            return resolve(static_cast<const IdentifierNode*>(expr)->getName());
+        case ASTNode::NODE_BINARY_OP: {
+            const BinaryOpNode* binary = static_cast<const BinaryOpNode*>(expr);
+            Operator op = binary->getOp();
+            if (op == Operator::AND || op == Operator::OR) {
+                return lowerLogical(binary);
+            }
+            if (op == Operator::ASSIGN) {
+                // Only a name can be assigned; the value is the result
+                Operand value = lowerExpression(binary->getRight());
+                const ExpressionNode* target = binary->getLeft();
+                if (target && target->getType() == ASTNode::NODE_IDENTIFIER) {
+                    Operand var = resolve(static_cast<const IdentifierNode*>(target)->getName());
+                    emit(Opcode::COPY, var, value);
+                    return var;
+                }
+                return value;
+            }
+            Operand left = lowerExpression(binary->getLeft());
+            Operand right = lowerExpression(binary->getRight());
+            Operand result = newTemp();
+            emit(Opcode::BINARY, result, left, right, op);
+            return result;
+        }
+        case ASTNode::NODE_UNARY_OP: {
+            const UnaryOpNode* unary = static_cast<const UnaryOpNode*>(expr);
+            Operand operand = lowerExpression(unary->getOperand());
+            Operand result = newTemp();
+            emit(Opcode::UNARY, result, operand, none(), unary->getOp());
+            return result;
+        }
+        case ASTNode::NODE_CALL:
+            return lowerCall(static_cast<const CallNode*>(expr));
+        default:
+            return none();
+    }
+}
+
+// && and || only evaluate their right operand when the left one does not
+// decide the result, so they lower to control flow:
+//   branch left, rhs, short        (|| swaps the targets)
+//   rhs:   t = right != 0; jump join
+//   short: t = 0 (1 for ||);  jump join
+Operand Lowerer::lowerLogical(const BinaryOpNode* binary) {
+    bool isAnd = binary->getOp() == Operator::AND;
+    Operand result = newTemp();
+    Operand left = lowerExpression(binary->getLeft());
+
+    uint32_t rhs = newBlock();
+    uint32_t shortcut = newBlock();
+    uint32_t join = newBlock();
+    terminate(Opcode::BRANCH, left, isAnd ? rhs : shortcut, isAnd ? shortcut : rhs);
+
+    startBlock(rhs);
+    Operand right = lowerExpression(binary->getRight());
+    emit(Opcode::BINARY, result, right, immediate(0), Operator::NE);
+    jump(join);
+
+    startBlock(shortcut);
+    emit(Opcode::COPY, result, immediate(isAnd ? 0 : 1));
+    jump(join);
+
+    startBlock(join);
+    return result;
+}
+
+Operand Lowerer::lowerCall(const CallNode* call) {
+    // Arguments are evaluated before any is passed, so a call inside an
+    // argument does not split this call's ARG run
+    std::vector<Operand> args;
+    args.reserve(call->getArgs().size());
+    for (const ExpressionNode* arg : call->getArgs()) {
+        args.push_back(lowerExpression(arg));
+    }
+    for (const Operand& arg : args) {
+        emit(Opcode::ARG, none(), arg);
+    }
+
+    Operand result = newTemp();
+    emit(Opcode::CALL, result, Operand{Operand::FUNCTION, call->getName()},
+         immediate(static_cast<uint32_t>(args.size())));
+    return result;
+}
+
+uint32_t Lowerer::declare(SymbolId name, SymbolId type) {
+    uint32_t index = static_cast<uint32_t>(function.variables.size());
+    function.variables.push_back(Variable{name, type});
+
+    variables.declare(name, index);
+    return index;
+}
+
+Operand Lowerer::resolve(SymbolId name) const {
+    if (const uint32_t* index = variables.find(name)) {
+        return Operand{Operand::VAR, *index};
+    }
+    return Operand{Operand::GLOBAL, name};
+}
+
+// Append-only text with the << of a stream, minus the per-call sentry and
+// locale work that make ostream output slow for many small pieces
+struct TextBuffer {
+    std::string data;
+
+    TextBuffer& operator<<(std::string_view text) {
+        data.append(text);
+        return *this;
+    }
+    TextBuffer& operator<<(uint32_t value) {
+        char digits[16];
+        char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        data.append(digits, end);
+        return *this;
+    }
+};
+
+// Prints one function into a buffer that is written out in one piece. A
+// name declared more than once in the function is suffixed with the
+// declaration's number so the copies stay apart.
+class Printer {
+public:
+    Printer(const Function& function, const StringInterner& names)
+        : function(function), names(names) {}
+
+    void print(std::ostream& stream);
+
+private:
+    const Function& function;
+    const StringInterner& names;
+    TextBuffer out;
+    std::vector<std::string> variableNames;
+
+    void printOperand(const Operand& operand);
+    void printInstruction(const Instruction& ins, const BasicBlock& block);
+    void printBlockList(uint32_t first, uint32_t count);
+};
+
+void Printer::print(std::ostream& stream) {
+    std::vector<uint32_t> seen;
+    for (const Variable& var : function.variables) {
+        if (var.name >= seen.size()) {
+            seen.resize(var.name + 1, 0);
+        }
+        std::string name(names.text(var.name));
+        if (seen[var.name]++ > 0) {
+            name += "." + std::to_string(seen[var.name] - 1);
+        }
+        variableNames.push_back(name);
+    }
+
+    out << "function " << names.text(function.returnType) << " " << names.text(function.name) << "(";
+    for (uint32_t i = 0; i < function.parameterCount; i++) {
+        out << (i ? ", " : "") << names.text(function.variables[i].type) << " " << variableNames[i];
+    }
+    out << ")\n";
+    if (function.variables.size() > function.parameterCount) {
+        out << "  locals:";
+        for (uint32_t i = function.parameterCount; i < function.variables.size(); i++) {
+            out << (i > function.parameterCount ? ", " : " ")
+                << names.text(function.variables[i].type) << " " << variableNames[i];
+        }
+        out << "\n";
+    }
+
+    for (uint32_t b = 0; b < function.blocks.size(); b++) {
+        const BasicBlock& block = function.blocks[b];
+        out << "B" << b << ":";
+        if (block.predecessorCount > 0) {
+            out << "  ; preds ";
+            printBlockList(block.predecessors, block.predecessorCount);
+        } else if (b > 0) {
+            out << "  ; unreachable";
+        }
+        out << "\n";
+        for (uint32_t i = block.first; i < block.first + block.count; i++) {
+            out << "  ";
+            printInstruction(function.instructions[i], block);
+            out << "\n";
+        }
+    }
+    stream.write(out.data.data(), static_cast<std::streamsize>(out.data.size()));
+}
+
+void Printer::printOperand(const Operand& operand) {
+    switch (operand.kind) {
+        case Operand::TEMP:
+            out << "t" << operand.id;
+            break;
+        case Operand::VAR:
+            out << variableNames[operand.id];
+            break;
+        case Operand::GLOBAL:
+        case Operand::CONST:
+        case Operand::FUNCTION:
+            out << names.text(operand.id);
+            break;
+        case Operand::IMMEDIATE:
+            out << operand.id;
+            break;
+        case Operand::NONE:
+            out << "_";
+            break;
+    }
+}
+
+void Printer::printInstruction(const Instruction& ins, const BasicBlock& block) {
+    switch (ins.opcode) {
+        case Opcode::COPY:
+            printOperand(ins.dst);
+            out << " = ";
+            printOperand(ins.a);
+            break;
+        case Opcode::BINARY:
+            printOperand(ins.dst);
+            out << " = ";
+            printOperand(ins.a);
+            out << " " << operatorSymbol(ins.op) << " ";
+            printOperand(ins.b);
+            break;
+        case Opcode::UNARY:
+            printOperand(ins.dst);
+            out << " = " << operatorSymbol(ins.op);
+            printOperand(ins.a);
+            break;
+        case Opcode::ARG:
+            out << "arg ";
+            printOperand(ins.a);
+            break;
+        case Opcode::CALL:
+            printOperand(ins.dst);
+            out << " = call ";
+            printOperand(ins.a);
+            out << ", " << ins.b.id;
+            break;
+        case Opcode::JUMP:
+            out << "jump ";
+            printBlockList(block.successors, block.successorCount);
+            break;
+        case Opcode::BRANCH:
+            out << "branch ";
+            printOperand(ins.a);
+            out << ", ";
+            printBlockList(block.successors, block.successorCount);
+            break;
+        case Opcode::RETURN:
+            out << "return";
+            if (ins.a.kind != Operand::NONE) {
+                out << " ";
+                printOperand(ins.a);
+            }
+            break;
+    }
+}
+
+void Printer::printBlockList(uint32_t first, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        out << (i ? ", " : "") << "B" << function.edges[first + i];
+    }
+}
+
+} // namespace
+
+std::vector<Function> lower(const TranslationUnit& unit) {
+    std::vector<Function> functions;
+    for (const StatementNode* stmt : unit.getStatements()) {
+        if (stmt && stmt->getType() == ASTNode::NODE_FUNCTION) {
+            functions.emplace_back();
+            Lowerer(functions.back()).lowerFunction(static_cast<const FunctionNode*>(stmt));
+        }
+    }
+    return functions;
+}
+
+void dump(const std::vector<Function>& functions, const StringInterner& names, std::ostream& out) {
+    for (size_t i = 0; i < functions.size(); i++) {
+        if (i > 0) {
+            out << "\n";
+        }
+        Printer(functions[i], names).print(out);
+    }
+}
+
+} // namespace ir
@@ -0,0 +1,90 @@
+#ifndef IR_H
+#define IR_H
+
+#include "ast.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Three-address IR lowered from function bodies, written by --ir.
+//
+// A function keeps all of its instructions in one dense vector. A basic
+// block is a contiguous range of that vector ending in exactly one
+// terminator (JUMP, BRANCH or RETURN); blocks are numbered in layout order
+// and block 0 is the entry. The CFG is explicit: the successors and the
+// predecessors of a block are ranges of the function's edge vector.
+// Terminators do not store their targets, they are the block's successors:
+// JUMP goes to successor 0, BRANCH to successor 0 when its condition is
+// non-zero and to successor 1 otherwise.
+namespace ir {
+
+enum class Opcode : uint8_t {
+    COPY,       // dst = a
+    BINARY,     // dst = a op b
+    UNARY,      // dst = op a
+    ARG,        // a is the next argument of the following CALL
+    CALL,       // dst = a(arguments), b is the argument count
+    JUMP,
+    BRANCH,     // on a
+    RETURN      // a, or nothing when a is NONE
+};
+
+struct Operand {
+    enum Kind : uint8_t {
+        NONE,
+        TEMP,       // id: temporary number
+        VAR,        // id: index into Function::variables
+        GLOBAL,     // id: SymbolId of a name the function does not declare
+        CONST,      // id: SymbolId of a literal's spelling
+        IMMEDIATE,  // id: the int value, for the 0 and 1 of && and ||
+        FUNCTION    // id: SymbolId of the callee
+    };
+
+    Kind kind;
+    uint32_t id;
+};
+
+struct Instruction {
+    Opcode opcode;
+    Operator op;            // For BINARY and UNARY
+    Operand dst;
+    Operand a;
+    Operand b;
+};
+
+struct BasicBlock {
+    uint32_t first;         // Range of Function::instructions
+    uint32_t count;
+    uint32_t successors;    // Range of Function::edges
+    uint32_t successorCount;
+    uint32_t predecessors;  // Range of Function::edges
+    uint32_t predecessorCount;
+};
+
+// A parameter or local; every declaration gets its own, so shadowing
+// variables with the same name are distinct
+struct Variable {
+    SymbolId name;
+    SymbolId type;
+};
+
+struct Function {
+    SymbolId name;
+    SymbolId returnType;
+    uint32_t parameterCount;            // The first variables
+    uint32_t tempCount;
+    std::vector<Variable> variables;
+    std::vector<Instruction> instructions;
+    std::vector<BasicBlock> blocks;
+    std::vector<uint32_t> edges;        // Block numbers
+};
+
+// Lowers every function of the unit; global declarations are not lowered
+std::vector<Function> lower(const TranslationUnit& unit);
+
+// Writes the functions as text, one instruction per line
+void dump(const std::vector<Function>& functions, const StringInterner& names, std::ostream& out);
+
+} // namespace ir
+
+#endif // IR_H
@@ -0,0 +1,325 @@
+#include "json_writer.h"
+#include <algorithm>
+#include <cstring>
+
+static const size_t BUFFER_SIZE = 1 << 16;
+
+JsonWriter::JsonWriter(bool compact)
+    : file(nullptr), buffer(BUFFER_SIZE), used(0), failed(false), compact(compact), names(nullptr) {}
+
+JsonWriter::~JsonWriter() {
+    close();
+}
+
+bool JsonWriter::open(const std::string& filename) {
+    close();
+    file = std::fopen(filename.c_str(), "wb");
+    failed = file == nullptr;
+    return file != nullptr;
+}
+
+bool JsonWriter::close() {
+    if (file) {
+        flushBuffer();
+        if (std::fclose(file) != 0) {
+            failed = true;
+        }
+        file = nullptr;
+    }
+    return !failed;
+}
+
+void JsonWriter::flushBuffer() {
+    if (used > 0 && file && std::fwrite(buffer.data(), 1, used, file) != used) {
+        failed = true;
+    }
+    used = 0;
+}
+
+void JsonWriter::raw(std::string_view text) {
+    while (!text.empty()) {
+        if (used == buffer.size()) {
+            flushBuffer();
+        }
+        size_t chunk = std::min(text.size(), buffer.size() - used);
+        std::memcpy(buffer.data() + used, text.data(), chunk);
+        used += chunk;
+        text.remove_prefix(chunk);
+    }
+}
+
+void JsonWriter::number(long value) {
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%ld", value);
+    raw(std::string_view(digits, length));
+}
+
+void JsonWriter::string(std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    put('"');
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"': raw("\\\""); break;
+            case '\\': raw("\\\\"); break;
+            case '\n': raw("\\n"); break;
+            case '\t': raw("\\t"); break;
+            case '\r': raw("\\r"); break;
+            default:
+                if (c < 0x20) {
+                    raw("\\u00");
+                    put(HEX[c >> 4]);
+                    put(HEX[c & 0xF]);
+                } else {
+                    put(static_cast<char>(c));
+                }
+                break;
+        }
+    }
+    put('"');
+}
+
+void JsonWriter::indent(int level) {
+    static const char SPACES[] = "                                ";
+    if (compact) {
+        return;
+    }
+    size_t width = static_cast<size_t>(level) * 2;
+    while (width > 0) {
+        size_t chunk = std::min(width, sizeof(SPACES) - 1);
+        raw(std::string_view(SPACES, chunk));
+        width -= chunk;
+    }
+}
+
+// Every node object starts with its "type" and ends with its "line"
+void JsonWriter::beginNode(const char* type, int level) {
+    indent(level);
+    raw(compact ? "{\"type\":" : "{\n");
+    if (!compact) {
+        indent(level);
+        raw("  \"type\": ");
+    }
+    string(type);
+}
+
+void JsonWriter::key(const char* name, int level) {
+    if (compact) {
+        put(',');
+        string(name);
+        put(':');
+    } else {
+        raw(",\n");
+        indent(level);
+        raw("  ");
+        string(name);
+        raw(": ");
+    }
+}
+
+void JsonWriter::endNode(const ASTNode* node, int level) {
+    key("line", level);
+    number(node->getLine());
+    if (!compact) {
+        put('\n');
+        indent(level);
+    }
+    put('}');
+}
+
+void JsonWriter::beginArray() {
+    raw(compact ? "[" : "[\n");
+}
+
+void JsonWriter::arraySeparator(bool last) {
+    if (!last) {
+        put(',');
+    }
+    if (!compact) {
+        put('\n');
+    }
+}
+
+void JsonWriter::endArray(int level) {
+    indent(level);
+    raw(compact ? "]" : "  ]");
+}
+
+void JsonWriter::writeChild(const ASTNode* node, int level) {
+    if (node) {
+        writeNode(node, level);
+    } else {
+        raw("null");
+    }
+}
+
+void JsonWriter::write(const TranslationUnit& unit) {
+    names = &unit.getNames();
+    const std::vector<StatementNode*>& statements = unit.getStatements();
+    beginArray();
+    for (size_t i = 0; i < statements.size(); i++) {
+        writeNode(statements[i], 1);
+        arraySeparator(i + 1 == statements.size());
+    }
+    raw("]\n");
+}
+
+void JsonWriter::writeNode(const ASTNode* node, int level) {
+    switch (node->getType()) {
+        case ASTNode::NODE_BINARY_OP: {
+            const BinaryOpNode* bin = static_cast<const BinaryOpNode*>(node);
+            beginNode("BinaryOp", level);
+            key("operator", level);
+            string(operatorSymbol(bin->getOp()));
+            key("left", level);
+            writeChild(bin->getLeft(), level + 1);
+            key("right", level);
+            writeChild(bin->getRight(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_UNARY_OP: {
+            const UnaryOpNode* un = static_cast<const UnaryOpNode*>(node);
+            beginNode("UnaryOp", level);
+            key("operator", level);
+            string(operatorSymbol(un->getOp()));
+            key("operand", level);
+            writeChild(un->getOperand(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_LITERAL: {
+            const LiteralNode* lit = static_cast<const LiteralNode*>(node);
+            beginNode("Literal", level);
+            key("value", level);
+            string(names->text(lit->getValue()));
+            key("literalType", level);
+            string(lit->getLiteralType());
+            break;
+        }
+        case ASTNode::NODE_IDENTIFIER: {
+            const IdentifierNode* id = static_cast<const IdentifierNode*>(node);
+            beginNode("Identifier", level);
+            key("name", level);
+            string(names->text(id->getName()));
+            break;
+        }
+        case ASTNode::NODE_IF: {
+            const IfNode* ifNode = static_cast<const IfNode*>(node);
+            beginNode("If", level);
+            key("condition", level);
+            writeChild(ifNode->getCondition(), level + 1);
+            key("thenBlock", level);
+            writeChild(ifNode->getThenBlock(), level + 1);
+            key("elseBlock", level);
+            writeChild(ifNode->getElseBlock(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_WHILE: {
+            const WhileNode* whileNode = static_cast<const WhileNode*>(node);
+            beginNode("While", level);
+            key("condition", level);
+            writeChild(whileNode->getCondition(), level + 1);
+            key("body", level);
+            writeChild(whileNode->getBody(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_FOR: {
+            const ForNode* forNode = static_cast<const ForNode*>(node);
+            beginNode("For", level);
+            key("init", level);
+            writeChild(forNode->getInit(), level + 1);
+            key("condition", level);
+            writeChild(forNode->getCondition(), level + 1);
+            key("increment", level);
+            writeChild(forNode->getIncrement(), level + 1);
+            key("body", level);
+            writeChild(forNode->getBody(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_FUNCTION: {
+            const FunctionNode* func = static_cast<const FunctionNode*>(node);
+            beginNode("Function", level);
+            key("name", level);
+            string(names->text(func->getName()));
+            key("returnType", level);
+            string(names->text(func->getReturnType()));
+            key("params", level);
+            beginArray();
+            const ArenaSpan<Parameter>& params = func->getParams();
+            for (size_t i = 0; i < params.size(); i++) {
+                indent(level + 2);
+                raw(compact ? "{\"type\":" : "{\"type\": ");
+                string(names->text(params[i].type));
+                raw(compact ? ",\"name\":" : ", \"name\": ");
+                string(names->text(params[i].name));
+                put('}');
+                arraySeparator(i + 1 == params.size());
+            }
+            endArray(level);
+            key("body", level);
+            writeChild(func->getBody(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_CALL: {
+            const CallNode* call = static_cast<const CallNode*>(node);
+            beginNode("Call", level);
+            key("name", level);
+            string(names->text(call->getName()));
+            key("args", level);
+            beginArray();
+            const ArenaSpan<ExpressionNode*>& args = call->getArgs();
+            for (size_t i = 0; i < args.size(); i++) {
+                writeNode(args[i], level + 2);
+                arraySeparator(i + 1 == args.size());
+            }
+            endArray(level);
+            break;
+        }
+        case ASTNode::NODE_VAR_DECL: {
+            const VarDeclNode* decl = static_cast<const VarDeclNode*>(node);
+            beginNode("VarDecl", level);
+            key("varType", level);
+            string(names->text(decl->getVarType()));
+            key("name", level);
+            string(names->text(decl->getName()));
+            key("initializer", level);
+            writeChild(decl->getInitializer(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_ASSIGN: {
+            const AssignNode* assign = static_cast<const AssignNode*>(node);
+            beginNode("Assign", level);
+            key("name", level);
+            string(names->text(assign->getName()));
+            key("value", level);
+            writeChild(assign->getValue(), level + 1);
+            break;
+        }
+        case ASTNode::NODE_BLOCK: {
+            const BlockNode* block = static_cast<const BlockNode*>(node);
+            beginNode("Block", level);
+            key("statements", level);
+            beginArray();
+            const ArenaSpan<StatementNode*>& statements = block->getStatements();
+            for (size_t i = 0; i < statements.size(); i++) {
+                writeNode(statements[i], level + 2);
+                arraySeparator(i + 1 == statements.size());
+            }
+            endArray(level);
+            break;
+        }
+        case ASTNode::NODE_RETURN:
+            beginNode("Return", level);
+            key("value", level);
+            writeChild(static_cast<const ReturnNode*>(node)->getValue(), level + 1);
+            break;
+        case ASTNode::NODE_BREAK:
+            beginNode("Break", level);
+            break;
+        case ASTNode::NODE_CONTINUE:
+            beginNode("Continue", level);
+            break;
+        default:
+            beginNode("Unknown", level);
+            break;
+    }
+    endNode(node, level);
+}
@@ -0,0 +1,58 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "ast.h"
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes the AST of a translation unit as JSON in a single traversal.
+// Output goes through a fixed 64 KB buffer straight to the file, so memory
+// does not grow with the size of the tree. The default layout is the
+// indented one the visualizer reads; compact mode drops all whitespace.
+class JsonWriter {
+public:
+    explicit JsonWriter(bool compact = false);
+    ~JsonWriter();
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    bool open(const std::string& filename);
+    void write(const TranslationUnit& unit);
+    // Flushes and closes the file; false if any write failed
+    bool close();
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    bool failed;
+    bool compact;
+    const StringInterner* names;
+
+    void flushBuffer();
+    void put(char c) {
+        if (used == buffer.size()) {
+            flushBuffer();
+        }
+        buffer[used++] = c;
+    }
+    void raw(std::string_view text);
+    void number(long value);
+    void string(std::string_view text);
+    void indent(int level);
+
+    void beginNode(const char* type, int level);
+    void key(const char* name, int level);
+    void endNode(const ASTNode* node, int level);
+    void beginArray();
+    void arraySeparator(bool last);
+    void endArray(int level);
+
+    void writeNode(const ASTNode* node, int level);
+    void writeChild(const ASTNode* node, int level);
+};
+
+#endif // JSON_WRITER_H
@@ -1,30 +1,119 @@
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <vector>
 #include "ast.h"
 #include "semantic.h"
+#include "constfold.h"
+#include "dce.h"
 #include "codegen.h"
-#include "parser.tab.hh"
+#include "ir.h"
+#include "json_writer.h"
+#include "ast_binary.h"
+#include "driver.h"
+#include "batch.h"
 
-extern std::vector<std::unique_ptr<StatementNode>> g_ast;
-extern FILE* yyin;
-int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc);
+static bool parseSource(const std::string& inputFile, TranslationUnit& unit) {
+    FILE* file = fopen(inputFile.c_str(), "r");
+    if (!file) {
+        std::cerr << "Error: Cannot open file " << inputFile << std::endl;
+        return false;
+    }
+
+    std::cout << "Parsing " << inputFile << "..." << std::endl;
+    
+    bool parsed = parseFile(file, unit);
+    fclose(file);
+
+    if (!parsed) {
+        std::cerr << "Parse error!" << std::endl;
+        return false;
+    }
+
+    std::cout << "Parse successful! Found " << unit.size() << " top-level statements." << std::endl;
+    return true;
+}
+
+// Loads an AST written earlier with --ast-bin instead of parsing source
+static bool loadBinaryAst(const std::string& inputFile, TranslationUnit& unit) {
+    std::cout << "Loading binary AST " << inputFile << "..." << std::endl;
+
+    astbin::AstFile astFile;
+    if (!astFile.open(inputFile)) {
+        return false;
+    }
+    if (!astFile.load(unit)) {
+        std::cerr << "Error: " << inputFile << " is truncated or corrupt" << std::endl;
+        return false;
+    }
+
+    std::cout << "Load successful! Found " << unit.size() << " top-level statements." << std::endl;
+    return true;
+}
+
+// --batch <file>... [--threads N] [--semantic]
+static int runBatch(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    size_t threadCount = 0;
+    bool runSemantic = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threadCount = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--semantic") {
+            runSemantic = true;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<batch::FileResult> results = batch::parseFiles(files, threadCount, runSemantic);
+    auto end = std::chrono::steady_clock::now();
+
+    batch::printReport(results, runSemantic, std::chrono::duration<double>(end - start).count());
+
+    for (const auto& result : results) {
+        if (!result.opened || !result.parsed) {
+            return 1;
+        }
+    }
+    return 0;
+}
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file> [options]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <input_file|input.ast> [options]" << std::endl;
         std::cerr << "Options:" << std::endl;
         std::cerr << "  --json <output.json>    Export AST to JSON" << std::endl;
+        std::cerr << "  --compact               Write the JSON without indentation" << std::endl;
+        std::cerr << "  --ast-bin <output.ast>  Save the AST in binary form; pass it as input to skip parsing" << std::endl;
         std::cerr << "  --code <output.c>      Generate C code" << std::endl;
+        std::cerr << "  --ir <output.ir>        Dump the three-address IR of every function" << std::endl;
         std::cerr << "  --semantic              Run semantic analysis" << std::endl;
+        std::cerr << "  --opt                   Fold constants and remove dead code before --json and --code" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch <input_file>... [--threads N] [--semantic]" << std::endl;
+        std::cerr << "  --batch                 Parse many files on a thread pool and print a summary" << std::endl;
+        std::cerr << "  --threads <N>           Worker threads for --batch (default: all hardware threads)" << std::endl;
         return 1;
     }
 
+    if (std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+
     std::string inputFile = argv[1];
     std::string jsonFile;
     std::string codeFile;
+    std::string astBinFile;
+    std::string irFile;
     bool runSemantic = false;
+    bool compactJson = false;
+    bool optimize = false;
 
     // Parse arguments
     for (int i = 2; i < argc; i++) {
@@ -33,39 +122,40 @@ int main(int argc, char* argv[]) {
             jsonFile = argv[++i];
         } else if (arg == "--code" && i + 1 < argc) {
             codeFile = argv[++i];
+        } else if (arg == "--ast-bin" && i + 1 < argc) {
+            astBinFile = argv[++i];
+        } else if (arg == "--ir" && i + 1 < argc) {
+            irFile = argv[++i];
         } else if (arg == "--semantic") {
             runSemantic = true;
+        } else if (arg == "--compact") {
+            compactJson = true;
+        } else if (arg == "--opt") {
+            optimize = true;
         }
     }
 
-    // Open input file
-    FILE* file = fopen(inputFile.c_str(), "r");
-    if (!file) {
-        std::cerr << "Error: Cannot open file " << inputFile << std::endl;
+    TranslationUnit unit;
+    bool loaded = astbin::isBinaryAst(inputFile) ? loadBinaryAst(inputFile, unit) : parseSource(inputFile, unit);
+    if (!loaded) {
         return 1;
     }
 
-    yyin = file;
-    g_ast.clear();
-
-    std::cout << "Parsing " << inputFile << "..." << std::endl;
-    
-    yy::parser parser;
-    int result = parser.parse();
-    fclose(file);
-
-    if (result != 0) {
-        std::cerr << "Parse error!" << std::endl;
-        return 1;
+    // Binary AST for later runs
+    if (!astBinFile.empty()) {
+        std::cout << "\nWriting binary AST to " << astBinFile << "..." << std::endl;
+        if (astbin::write(unit, astBinFile)) {
+            std::cout << "Binary AST written successfully!" << std::endl;
+        } else {
+            std::cerr << "Error: Cannot write to " << astBinFile << std::endl;
+        }
     }
 
-    std::cout << "Parse successful! Found " << g_ast.size() << " top-level statements." << std::endl;
-
     // Semantic analysis
     if (runSemantic) {
         std::cout << "\nRunning semantic analysis..." << std::endl;
         SemanticAnalyzer analyzer;
-        bool success = analyzer.analyze(g_ast);
+        bool success = analyzer.analyze(unit);
         
         if (!success || !analyzer.getErrors().empty()) {
             std::cerr << "Semantic errors:" << std::endl;
@@ -75,23 +165,34 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Optimization rewrites the tree, so it runs after analysis of the source
+    if (optimize) {
+        std::cout << "\nOptimizing..." << std::endl;
+        ConstantFolder folder;
+        folder.fold(unit);
+        std::cout << "Constant folding: " << folder.getFoldedCount() << " expressions folded, "
+                  << folder.getPropagatedCount() << " constants propagated" << std::endl;
+
+        DeadCodeEliminator eliminator;
+        eliminator.eliminate(unit);
+        std::cout << "Dead code elimination: removed " << eliminator.getUnreachableCount()
+                  << " unreachable statements, " << eliminator.getBranchCount() << " branches, "
+                  << eliminator.getLoopCount() << " loops, " << eliminator.getVariableCount()
+                  << " unused variables" << std::endl;
+    }
+
     // Export AST to JSON
     if (!jsonFile.empty()) {
         std::cout << "\nExporting AST to " << jsonFile << "..." << std::endl;
-        std::ofstream jsonOut(jsonFile);
+        JsonWriter writer(compactJson);
         
-        if (jsonOut.is_open()) {
-            jsonOut << "[" << std::endl;
-            for (size_t i = 0; i < g_ast.size(); i++) {
-                jsonOut << g_ast[i]->toJSON(1);
-                if (i < g_ast.size() - 1) {
-                    jsonOut << ",";
-                }
-                jsonOut << std::endl;
+        if (writer.open(jsonFile)) {
+            writer.write(unit);
+            if (writer.close()) {
+                std::cout << "AST exported successfully!" << std::endl;
+            } else {
+                std::cerr << "Error: Cannot write to " << jsonFile << std::endl;
             }
-            jsonOut << "]" << std::endl;
-            jsonOut.close();
-            std::cout << "AST exported successfully!" << std::endl;
         } else {
             std::cerr << "Error: Cannot write to " << jsonFile << std::endl;
         }
@@ -101,7 +202,7 @@ int main(int argc, char* argv[]) {
     if (!codeFile.empty()) {
         std::cout << "\nGenerating C code to " << codeFile << "..." << std::endl;
         CodeGenerator generator;
-        std::string code = generator.generate(g_ast);
+        std::string code = generator.generate(unit);
         
         std::ofstream codeOut(codeFile);
         if (codeOut.is_open()) {
@@ -113,6 +214,21 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Lower to IR
+    if (!irFile.empty()) {
+        std::cout << "\nWriting IR to " << irFile << "..." << std::endl;
+        std::vector<ir::Function> functions = ir::lower(unit);
+
+        std::ofstream irOut(irFile);
+        if (irOut.is_open()) {
+            ir::dump(functions, unit.getNames(), irOut);
+            irOut.close();
+            std::cout << "IR written successfully! (" << functions.size() << " functions)" << std::endl;
+        } else {
+            std::cerr << "Error: Cannot write to " << irFile << std::endl;
+        }
+    }
+
     return 0;
 }
 
@@ -37,32 +37,42 @@
 
 
 // First part of user prologue.
-#line 19 "parser.y"
+#line 31 "parser.y"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
 
-extern int yylineno;
-extern FILE* yyin;
 
-static std::string take_owned_text(char* text) {
-    if (!text) {
-        return std::string();
-    }
-    std::string result(text);
-    free(text);
-    return result;
-}
+#line 49 "parser.tab.cc"
 
 
-#line 61 "parser.tab.cc"
+#include "parser.tab.hh"
 
 
-#include "parser.tab.hh"
+// Unqualified %code blocks.
+#line 39 "parser.y"
+
+// Every node of the tree is allocated in the unit's arena
+#define arena() unit.getArena()
+
+// Identifiers, type names and literal spellings are interned in the unit
+#define names() unit.getNames()
+
+// Line the scanner has reached, used as the line of the node being reduced
+#define yylineno yyget_lineno(scanner)
 
+// Wraps a single statement (or nothing) into a block for if/while/for bodies
+static BlockNode* wrap_in_block(Arena& arena, StatementNode* stmt) {
+    ArenaListBuilder<StatementNode*> statements;
+    if (stmt) {
+        statements.append(arena, stmt);
+    }
+    return arena.make<BlockNode>(statements.finish(arena));
+}
 
+#line 76 "parser.tab.cc"
 
 
 #ifndef YY_
@@ -154,16 +164,18 @@ static std::string take_owned_text(char* text) {
 #define YYRECOVERING()  (!!yyerrstatus_)
 
 namespace yy {
-#line 158 "parser.tab.cc"
+#line 168 "parser.tab.cc"
 
   /// Build a parser object.
-  parser::parser ()
+  parser::parser (yyscan_t scanner_yyarg, TranslationUnit& unit_yyarg)
 #if YYDEBUG
     : yydebug_ (false),
-      yycdebug_ (&std::cerr)
+      yycdebug_ (&std::cerr),
 #else
-
+    :
 #endif
+      scanner (scanner_yyarg),
+      unit (unit_yyarg)
   {}
 
   parser::~parser ()
@@ -185,47 +197,44 @@ namespace yy {
   {
     switch (this->kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.copy< char* > (YY_MOVE (that.value));
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.copy< int > (YY_MOVE (that.value));
+      case symbol_kind::S_expression_list: // expression_list
+        value.copy< ArenaListBuilder<ExpressionNode*> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.copy< std::pair<std::string, std::string> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.copy< ArenaListBuilder<Parameter> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.copy< std::string > (YY_MOVE (that.value));
+      case symbol_kind::S_statement_list: // statement_list
+        value.copy< ArenaListBuilder<StatementNode*> > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_block: // block
-        value.copy< std::unique_ptr<BlockNode> > (YY_MOVE (that.value));
+        value.copy< BlockNode* > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_expression: // expression
-        value.copy< std::unique_ptr<ExpressionNode> > (YY_MOVE (that.value));
+        value.copy< ExpressionNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.copy< std::unique_ptr<StatementNode> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter: // parameter
+        value.copy< Parameter > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.copy< std::vector<std::pair<std::string, std::string>> > (YY_MOVE (that.value));
+      case symbol_kind::S_statement: // statement
+        value.copy< StatementNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.copy< std::vector<std::unique_ptr<ExpressionNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.copy< SymbolId > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.copy< std::vector<std::unique_ptr<StatementNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.copy< int > (YY_MOVE (that.value));
         break;
 
       default:
@@ -259,47 +268,44 @@ namespace yy {
     super_type::move (s);
     switch (this->kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.move< char* > (YY_MOVE (s.value));
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.move< int > (YY_MOVE (s.value));
+      case symbol_kind::S_expression_list: // expression_list
+        value.move< ArenaListBuilder<ExpressionNode*> > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.move< std::pair<std::string, std::string> > (YY_MOVE (s.value));
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< ArenaListBuilder<Parameter> > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.move< std::string > (YY_MOVE (s.value));
+      case symbol_kind::S_statement_list: // statement_list
+        value.move< ArenaListBuilder<StatementNode*> > (YY_MOVE (s.value));
         break;
 
       case symbol_kind::S_block: // block
-        value.move< std::unique_ptr<BlockNode> > (YY_MOVE (s.value));
+        value.move< BlockNode* > (YY_MOVE (s.value));
         break;
 
       case symbol_kind::S_expression: // expression
-        value.move< std::unique_ptr<ExpressionNode> > (YY_MOVE (s.value));
+        value.move< ExpressionNode* > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.move< std::unique_ptr<StatementNode> > (YY_MOVE (s.value));
+      case symbol_kind::S_parameter: // parameter
+        value.move< Parameter > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.move< std::vector<std::pair<std::string, std::string>> > (YY_MOVE (s.value));
+      case symbol_kind::S_statement: // statement
+        value.move< StatementNode* > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.move< std::vector<std::unique_ptr<ExpressionNode>> > (YY_MOVE (s.value));
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.move< SymbolId > (YY_MOVE (s.value));
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.move< std::vector<std::unique_ptr<StatementNode>> > (YY_MOVE (s.value));
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.move< int > (YY_MOVE (s.value));
         break;
 
       default:
@@ -403,47 +409,44 @@ namespace yy {
   {
     switch (that.kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.YY_MOVE_OR_COPY< char* > (YY_MOVE (that.value));
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.YY_MOVE_OR_COPY< int > (YY_MOVE (that.value));
+      case symbol_kind::S_expression_list: // expression_list
+        value.YY_MOVE_OR_COPY< ArenaListBuilder<ExpressionNode*> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.YY_MOVE_OR_COPY< std::pair<std::string, std::string> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.YY_MOVE_OR_COPY< ArenaListBuilder<Parameter> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.YY_MOVE_OR_COPY< std::string > (YY_MOVE (that.value));
+      case symbol_kind::S_statement_list: // statement_list
+        value.YY_MOVE_OR_COPY< ArenaListBuilder<StatementNode*> > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_block: // block
-        value.YY_MOVE_OR_COPY< std::unique_ptr<BlockNode> > (YY_MOVE (that.value));
+        value.YY_MOVE_OR_COPY< BlockNode* > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_expression: // expression
-        value.YY_MOVE_OR_COPY< std::unique_ptr<ExpressionNode> > (YY_MOVE (that.value));
+        value.YY_MOVE_OR_COPY< ExpressionNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.YY_MOVE_OR_COPY< std::unique_ptr<StatementNode> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter: // parameter
+        value.YY_MOVE_OR_COPY< Parameter > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.YY_MOVE_OR_COPY< std::vector<std::pair<std::string, std::string>> > (YY_MOVE (that.value));
+      case symbol_kind::S_statement: // statement
+        value.YY_MOVE_OR_COPY< StatementNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.YY_MOVE_OR_COPY< std::vector<std::unique_ptr<ExpressionNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.YY_MOVE_OR_COPY< SymbolId > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.YY_MOVE_OR_COPY< std::vector<std::unique_ptr<StatementNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.YY_MOVE_OR_COPY< int > (YY_MOVE (that.value));
         break;
 
       default:
@@ -461,47 +464,44 @@ namespace yy {
   {
     switch (that.kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.move< char* > (YY_MOVE (that.value));
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.move< int > (YY_MOVE (that.value));
+      case symbol_kind::S_expression_list: // expression_list
+        value.move< ArenaListBuilder<ExpressionNode*> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.move< std::pair<std::string, std::string> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< ArenaListBuilder<Parameter> > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.move< std::string > (YY_MOVE (that.value));
+      case symbol_kind::S_statement_list: // statement_list
+        value.move< ArenaListBuilder<StatementNode*> > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_block: // block
-        value.move< std::unique_ptr<BlockNode> > (YY_MOVE (that.value));
+        value.move< BlockNode* > (YY_MOVE (that.value));
         break;
 
       case symbol_kind::S_expression: // expression
-        value.move< std::unique_ptr<ExpressionNode> > (YY_MOVE (that.value));
+        value.move< ExpressionNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.move< std::unique_ptr<StatementNode> > (YY_MOVE (that.value));
+      case symbol_kind::S_parameter: // parameter
+        value.move< Parameter > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.move< std::vector<std::pair<std::string, std::string>> > (YY_MOVE (that.value));
+      case symbol_kind::S_statement: // statement
+        value.move< StatementNode* > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.move< std::vector<std::unique_ptr<ExpressionNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.move< SymbolId > (YY_MOVE (that.value));
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.move< std::vector<std::unique_ptr<StatementNode>> > (YY_MOVE (that.value));
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.move< int > (YY_MOVE (that.value));
         break;
 
       default:
@@ -519,47 +519,44 @@ namespace yy {
     state = that.state;
     switch (that.kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.copy< char* > (that.value);
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.copy< int > (that.value);
+      case symbol_kind::S_expression_list: // expression_list
+        value.copy< ArenaListBuilder<ExpressionNode*> > (that.value);
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.copy< std::pair<std::string, std::string> > (that.value);
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.copy< ArenaListBuilder<Parameter> > (that.value);
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.copy< std::string > (that.value);
+      case symbol_kind::S_statement_list: // statement_list
+        value.copy< ArenaListBuilder<StatementNode*> > (that.value);
         break;
 
       case symbol_kind::S_block: // block
-        value.copy< std::unique_ptr<BlockNode> > (that.value);
+        value.copy< BlockNode* > (that.value);
         break;
 
       case symbol_kind::S_expression: // expression
-        value.copy< std::unique_ptr<ExpressionNode> > (that.value);
+        value.copy< ExpressionNode* > (that.value);
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.copy< std::unique_ptr<StatementNode> > (that.value);
+      case symbol_kind::S_parameter: // parameter
+        value.copy< Parameter > (that.value);
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.copy< std::vector<std::pair<std::string, std::string>> > (that.value);
+      case symbol_kind::S_statement: // statement
+        value.copy< StatementNode* > (that.value);
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.copy< std::vector<std::unique_ptr<ExpressionNode>> > (that.value);
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.copy< SymbolId > (that.value);
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.copy< std::vector<std::unique_ptr<StatementNode>> > (that.value);
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.copy< int > (that.value);
         break;
 
       default:
@@ -576,47 +573,44 @@ namespace yy {
     state = that.state;
     switch (that.kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.move< char* > (that.value);
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.move< int > (that.value);
+      case symbol_kind::S_expression_list: // expression_list
+        value.move< ArenaListBuilder<ExpressionNode*> > (that.value);
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.move< std::pair<std::string, std::string> > (that.value);
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< ArenaListBuilder<Parameter> > (that.value);
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.move< std::string > (that.value);
+      case symbol_kind::S_statement_list: // statement_list
+        value.move< ArenaListBuilder<StatementNode*> > (that.value);
         break;
 
       case symbol_kind::S_block: // block
-        value.move< std::unique_ptr<BlockNode> > (that.value);
+        value.move< BlockNode* > (that.value);
         break;
 
       case symbol_kind::S_expression: // expression
-        value.move< std::unique_ptr<ExpressionNode> > (that.value);
+        value.move< ExpressionNode* > (that.value);
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.move< std::unique_ptr<StatementNode> > (that.value);
+      case symbol_kind::S_parameter: // parameter
+        value.move< Parameter > (that.value);
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.move< std::vector<std::pair<std::string, std::string>> > (that.value);
+      case symbol_kind::S_statement: // statement
+        value.move< StatementNode* > (that.value);
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.move< std::vector<std::unique_ptr<ExpressionNode>> > (that.value);
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.move< SymbolId > (that.value);
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.move< std::vector<std::unique_ptr<StatementNode>> > (that.value);
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.move< int > (that.value);
         break;
 
       default:
@@ -804,7 +798,7 @@ namespace yy {
         try
 #endif // YY_EXCEPTIONS
           {
-            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location));
+            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location, scanner));
           }
 #if YY_EXCEPTIONS
         catch (const syntax_error& yyexc)
@@ -877,47 +871,44 @@ namespace yy {
          when using variants.  */
       switch (yyr1_[yyn])
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        yylhs.value.emplace< char* > ();
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        yylhs.value.emplace< int > ();
+      case symbol_kind::S_expression_list: // expression_list
+        yylhs.value.emplace< ArenaListBuilder<ExpressionNode*> > ();
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        yylhs.value.emplace< std::pair<std::string, std::string> > ();
+      case symbol_kind::S_parameter_list: // parameter_list
+        yylhs.value.emplace< ArenaListBuilder<Parameter> > ();
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        yylhs.value.emplace< std::string > ();
+      case symbol_kind::S_statement_list: // statement_list
+        yylhs.value.emplace< ArenaListBuilder<StatementNode*> > ();
         break;
 
       case symbol_kind::S_block: // block
-        yylhs.value.emplace< std::unique_ptr<BlockNode> > ();
+        yylhs.value.emplace< BlockNode* > ();
         break;
 
       case symbol_kind::S_expression: // expression
-        yylhs.value.emplace< std::unique_ptr<ExpressionNode> > ();
+        yylhs.value.emplace< ExpressionNode* > ();
         break;
 
-      case symbol_kind::S_statement: // statement
-        yylhs.value.emplace< std::unique_ptr<StatementNode> > ();
+      case symbol_kind::S_parameter: // parameter
+        yylhs.value.emplace< Parameter > ();
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        yylhs.value.emplace< std::vector<std::pair<std::string, std::string>> > ();
+      case symbol_kind::S_statement: // statement
+        yylhs.value.emplace< StatementNode* > ();
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        yylhs.value.emplace< std::vector<std::unique_ptr<ExpressionNode>> > ();
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        yylhs.value.emplace< SymbolId > ();
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        yylhs.value.emplace< std::vector<std::unique_ptr<StatementNode>> > ();
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        yylhs.value.emplace< int > ();
         break;
 
       default:
@@ -941,502 +932,480 @@ namespace yy {
           switch (yyn)
             {
   case 2: // program: translation_unit
-#line 72 "parser.y"
+#line 92 "parser.y"
                      { }
-#line 947 "parser.tab.cc"
+#line 938 "parser.tab.cc"
     break;
 
   case 3: // translation_unit: %empty
-#line 76 "parser.y"
+#line 96 "parser.y"
                 { }
-#line 953 "parser.tab.cc"
+#line 944 "parser.tab.cc"
     break;
 
   case 4: // translation_unit: translation_unit function_definition
-#line 77 "parser.y"
+#line 97 "parser.y"
                                            { }
-#line 959 "parser.tab.cc"
+#line 950 "parser.tab.cc"
     break;
 
   case 5: // translation_unit: translation_unit declaration
-#line 78 "parser.y"
+#line 98 "parser.y"
                                    { }
-#line 965 "parser.tab.cc"
+#line 956 "parser.tab.cc"
     break;
 
   case 6: // function_definition: type_specifier IDENTIFIER '(' parameter_list ')' block
-#line 82 "parser.y"
+#line 102 "parser.y"
                                                            {
-        g_ast.push_back(std::make_unique<FunctionNode>(take_owned_text(yystack_[4].value.as < char* > ()), yystack_[5].value.as < std::string > (), std::move(yystack_[2].value.as < std::vector<std::pair<std::string, std::string>> > ()), std::move(yystack_[0].value.as < std::unique_ptr<BlockNode> > ()), yylineno));
+        unit.add(arena().make<FunctionNode>(yystack_[4].value.as < SymbolId > (), yystack_[5].value.as < SymbolId > (), yystack_[2].value.as < ArenaListBuilder<Parameter> > ().finish(arena()), yystack_[0].value.as < BlockNode* > (), yylineno));
     }
-#line 973 "parser.tab.cc"
+#line 964 "parser.tab.cc"
     break;
 
   case 7: // function_definition: type_specifier IDENTIFIER '(' ')' block
-#line 85 "parser.y"
+#line 105 "parser.y"
                                               {
-        std::vector<std::pair<std::string, std::string>> params;
-        g_ast.push_back(std::make_unique<FunctionNode>(take_owned_text(yystack_[3].value.as < char* > ()), yystack_[4].value.as < std::string > (), std::move(params), std::move(yystack_[0].value.as < std::unique_ptr<BlockNode> > ()), yylineno));
+        unit.add(arena().make<FunctionNode>(yystack_[3].value.as < SymbolId > (), yystack_[4].value.as < SymbolId > (), ArenaSpan<Parameter>(), yystack_[0].value.as < BlockNode* > (), yylineno));
     }
-#line 982 "parser.tab.cc"
+#line 972 "parser.tab.cc"
     break;
 
   case 8: // parameter_list: parameter
-#line 92 "parser.y"
+#line 111 "parser.y"
               {
-        yylhs.value.as < std::vector<std::pair<std::string, std::string>> > () = std::vector<std::pair<std::string, std::string>>();
-        yylhs.value.as < std::vector<std::pair<std::string, std::string>> > ().push_back(yystack_[0].value.as < std::pair<std::string, std::string> > ());
+        yylhs.value.as < ArenaListBuilder<Parameter> > () = ArenaListBuilder<Parameter>();
+        yylhs.value.as < ArenaListBuilder<Parameter> > ().append(arena(), yystack_[0].value.as < Parameter > ());
     }
-#line 991 "parser.tab.cc"
+#line 981 "parser.tab.cc"
     break;
 
   case 9: // parameter_list: parameter_list ',' parameter
-#line 96 "parser.y"
+#line 115 "parser.y"
                                    {
-        yylhs.value.as < std::vector<std::pair<std::string, std::string>> > () = std::move(yystack_[2].value.as < std::vector<std::pair<std::string, std::string>> > ());
-        yylhs.value.as < std::vector<std::pair<std::string, std::string>> > ().push_back(yystack_[0].value.as < std::pair<std::string, std::string> > ());
+        yylhs.value.as < ArenaListBuilder<Parameter> > () = yystack_[2].value.as < ArenaListBuilder<Parameter> > ();
+        yylhs.value.as < ArenaListBuilder<Parameter> > ().append(arena(), yystack_[0].value.as < Parameter > ());
     }
-#line 1000 "parser.tab.cc"
+#line 990 "parser.tab.cc"
     break;
 
   case 10: // parameter: type_specifier IDENTIFIER
-#line 103 "parser.y"
+#line 122 "parser.y"
                               {
-        yylhs.value.as < std::pair<std::string, std::string> > () = std::make_pair(yystack_[1].value.as < std::string > (), take_owned_text(yystack_[0].value.as < char* > ()));
+        yylhs.value.as < Parameter > () = Parameter{yystack_[1].value.as < SymbolId > (), yystack_[0].value.as < SymbolId > ()};
     }
-#line 1008 "parser.tab.cc"
+#line 998 "parser.tab.cc"
     break;
 
   case 11: // declaration: type_specifier IDENTIFIER ';'
-#line 109 "parser.y"
+#line 128 "parser.y"
                                   {
-        g_ast.push_back(std::make_unique<VarDeclNode>(yystack_[2].value.as < std::string > (), take_owned_text(yystack_[1].value.as < char* > ()), nullptr, yylineno));
+        unit.add(arena().make<VarDeclNode>(yystack_[2].value.as < SymbolId > (), yystack_[1].value.as < SymbolId > (), nullptr, yylineno));
     }
-#line 1016 "parser.tab.cc"
+#line 1006 "parser.tab.cc"
     break;
 
   case 12: // declaration: type_specifier IDENTIFIER '=' expression ';'
-#line 112 "parser.y"
+#line 131 "parser.y"
                                                    {
-        g_ast.push_back(std::make_unique<VarDeclNode>(yystack_[4].value.as < std::string > (), take_owned_text(yystack_[3].value.as < char* > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno));
+        unit.add(arena().make<VarDeclNode>(yystack_[4].value.as < SymbolId > (), yystack_[3].value.as < SymbolId > (), yystack_[1].value.as < ExpressionNode* > (), yylineno));
     }
-#line 1024 "parser.tab.cc"
+#line 1014 "parser.tab.cc"
     break;
 
   case 13: // type_specifier: INT
-#line 118 "parser.y"
-        { yylhs.value.as < std::string > () = "int"; }
-#line 1030 "parser.tab.cc"
+#line 137 "parser.y"
+        { yylhs.value.as < SymbolId > () = names().intern("int"); }
+#line 1020 "parser.tab.cc"
     break;
 
   case 14: // type_specifier: CHAR
-#line 119 "parser.y"
-           { yylhs.value.as < std::string > () = "char"; }
-#line 1036 "parser.tab.cc"
+#line 138 "parser.y"
+           { yylhs.value.as < SymbolId > () = names().intern("char"); }
+#line 1026 "parser.tab.cc"
     break;
 
   case 15: // type_specifier: FLOAT_TYPE
-#line 120 "parser.y"
-                 { yylhs.value.as < std::string > () = "float"; }
-#line 1042 "parser.tab.cc"
+#line 139 "parser.y"
+                 { yylhs.value.as < SymbolId > () = names().intern("float"); }
+#line 1032 "parser.tab.cc"
     break;
 
   case 16: // type_specifier: DOUBLE
-#line 121 "parser.y"
-             { yylhs.value.as < std::string > () = "double"; }
-#line 1048 "parser.tab.cc"
+#line 140 "parser.y"
+             { yylhs.value.as < SymbolId > () = names().intern("double"); }
+#line 1038 "parser.tab.cc"
     break;
 
   case 17: // type_specifier: VOID
-#line 122 "parser.y"
-           { yylhs.value.as < std::string > () = "void"; }
-#line 1054 "parser.tab.cc"
+#line 141 "parser.y"
+           { yylhs.value.as < SymbolId > () = names().intern("void"); }
+#line 1044 "parser.tab.cc"
     break;
 
   case 18: // statement: expression ';'
-#line 126 "parser.y"
+#line 145 "parser.y"
                    {
         // Expression statement - ignore result
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = nullptr;
+        yylhs.value.as < StatementNode* > () = nullptr;
     }
-#line 1063 "parser.tab.cc"
+#line 1053 "parser.tab.cc"
     break;
 
   case 19: // statement: block
-#line 130 "parser.y"
+#line 149 "parser.y"
             {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::move(yystack_[0].value.as < std::unique_ptr<BlockNode> > ());
+        yylhs.value.as < StatementNode* > () = yystack_[0].value.as < BlockNode* > ();
     }
-#line 1071 "parser.tab.cc"
+#line 1061 "parser.tab.cc"
     break;
 
   case 20: // statement: IF '(' expression ')' statement
-#line 133 "parser.y"
+#line 152 "parser.y"
                                       {
-        std::unique_ptr<BlockNode> thenBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            thenBlock->getStatements().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
-        }
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<IfNode>(std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(thenBlock), nullptr, yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<IfNode>(yystack_[2].value.as < ExpressionNode* > (), wrap_in_block(arena(), yystack_[0].value.as < StatementNode* > ()), nullptr, yylineno);
     }
-#line 1083 "parser.tab.cc"
+#line 1069 "parser.tab.cc"
     break;
 
   case 21: // statement: IF '(' expression ')' statement ELSE statement
-#line 140 "parser.y"
+#line 155 "parser.y"
                                                      {
-        std::unique_ptr<BlockNode> thenBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        std::unique_ptr<BlockNode> elseBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if (yystack_[2].value.as < std::unique_ptr<StatementNode> > ()) {
-            thenBlock->getStatements().push_back(std::move(yystack_[2].value.as < std::unique_ptr<StatementNode> > ()));
-        }
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            elseBlock->getStatements().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
-        }
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<IfNode>(std::move(yystack_[4].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(thenBlock), std::move(elseBlock), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<IfNode>(yystack_[4].value.as < ExpressionNode* > (), wrap_in_block(arena(), yystack_[2].value.as < StatementNode* > ()), wrap_in_block(arena(), yystack_[0].value.as < StatementNode* > ()), yylineno);
     }
-#line 1099 "parser.tab.cc"
+#line 1077 "parser.tab.cc"
     break;
 
   case 22: // statement: WHILE '(' expression ')' statement
-#line 151 "parser.y"
+#line 158 "parser.y"
                                          {
-        std::unique_ptr<BlockNode> body = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            body->getStatements().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
-        }
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<WhileNode>(std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(body), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<WhileNode>(yystack_[2].value.as < ExpressionNode* > (), wrap_in_block(arena(), yystack_[0].value.as < StatementNode* > ()), yylineno);
     }
-#line 1111 "parser.tab.cc"
+#line 1085 "parser.tab.cc"
     break;
 
   case 23: // statement: FOR '(' expression ';' expression ';' expression ')' statement
-#line 158 "parser.y"
+#line 161 "parser.y"
                                                                      {
-        std::unique_ptr<BlockNode> body = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            body->getStatements().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
-        }
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<ForNode>(nullptr, std::move(yystack_[4].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(body), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<ForNode>(nullptr, yystack_[4].value.as < ExpressionNode* > (), yystack_[2].value.as < ExpressionNode* > (), wrap_in_block(arena(), yystack_[0].value.as < StatementNode* > ()), yylineno);
     }
-#line 1123 "parser.tab.cc"
+#line 1093 "parser.tab.cc"
     break;
 
   case 24: // statement: RETURN ';'
-#line 165 "parser.y"
+#line 164 "parser.y"
                  {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<ReturnNode>(nullptr, yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<ReturnNode>(nullptr, yylineno);
     }
-#line 1131 "parser.tab.cc"
+#line 1101 "parser.tab.cc"
     break;
 
   case 25: // statement: RETURN expression ';'
-#line 168 "parser.y"
+#line 167 "parser.y"
                             {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<ReturnNode>(std::move(yystack_[1].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<ReturnNode>(yystack_[1].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1139 "parser.tab.cc"
+#line 1109 "parser.tab.cc"
     break;
 
   case 26: // statement: BREAK ';'
-#line 171 "parser.y"
+#line 170 "parser.y"
                 {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<BreakNode>(yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<BreakNode>(yylineno);
     }
-#line 1147 "parser.tab.cc"
+#line 1117 "parser.tab.cc"
     break;
 
   case 27: // statement: CONTINUE ';'
-#line 174 "parser.y"
+#line 173 "parser.y"
                    {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<ContinueNode>(yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<ContinueNode>(yylineno);
     }
-#line 1155 "parser.tab.cc"
+#line 1125 "parser.tab.cc"
     break;
 
   case 28: // statement: type_specifier IDENTIFIER ';'
-#line 177 "parser.y"
+#line 176 "parser.y"
                                     {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<VarDeclNode>(yystack_[2].value.as < std::string > (), take_owned_text(yystack_[1].value.as < char* > ()), nullptr, yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<VarDeclNode>(yystack_[2].value.as < SymbolId > (), yystack_[1].value.as < SymbolId > (), nullptr, yylineno);
     }
-#line 1163 "parser.tab.cc"
+#line 1133 "parser.tab.cc"
     break;
 
   case 29: // statement: type_specifier IDENTIFIER '=' expression ';'
-#line 180 "parser.y"
+#line 179 "parser.y"
                                                    {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<VarDeclNode>(yystack_[4].value.as < std::string > (), take_owned_text(yystack_[3].value.as < char* > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<VarDeclNode>(yystack_[4].value.as < SymbolId > (), yystack_[3].value.as < SymbolId > (), yystack_[1].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1171 "parser.tab.cc"
+#line 1141 "parser.tab.cc"
     break;
 
   case 30: // statement: IDENTIFIER '=' expression ';'
-#line 183 "parser.y"
+#line 182 "parser.y"
                                     {
-        yylhs.value.as < std::unique_ptr<StatementNode> > () = std::make_unique<AssignNode>(take_owned_text(yystack_[3].value.as < char* > ()), std::move(yystack_[1].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < StatementNode* > () = arena().make<AssignNode>(yystack_[3].value.as < SymbolId > (), yystack_[1].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1179 "parser.tab.cc"
+#line 1149 "parser.tab.cc"
     break;
 
   case 31: // block: '{' statement_list '}'
-#line 189 "parser.y"
+#line 188 "parser.y"
                            {
-        yylhs.value.as < std::unique_ptr<BlockNode> > () = std::make_unique<BlockNode>(std::move(yystack_[1].value.as < std::vector<std::unique_ptr<StatementNode>> > ()), yylineno);
+        yylhs.value.as < BlockNode* > () = arena().make<BlockNode>(yystack_[1].value.as < ArenaListBuilder<StatementNode*> > ().finish(arena()), yylineno);
     }
-#line 1187 "parser.tab.cc"
+#line 1157 "parser.tab.cc"
     break;
 
   case 32: // block: '{' '}'
-#line 192 "parser.y"
+#line 191 "parser.y"
               {
-        yylhs.value.as < std::unique_ptr<BlockNode> > () = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>(), yylineno);
+        yylhs.value.as < BlockNode* > () = arena().make<BlockNode>(ArenaSpan<StatementNode*>(), yylineno);
     }
-#line 1195 "parser.tab.cc"
+#line 1165 "parser.tab.cc"
     break;
 
   case 33: // statement_list: statement
-#line 198 "parser.y"
+#line 197 "parser.y"
               {
-        yylhs.value.as < std::vector<std::unique_ptr<StatementNode>> > () = std::vector<std::unique_ptr<StatementNode>>();
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            yylhs.value.as < std::vector<std::unique_ptr<StatementNode>> > ().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
+        yylhs.value.as < ArenaListBuilder<StatementNode*> > () = ArenaListBuilder<StatementNode*>();
+        if (yystack_[0].value.as < StatementNode* > ()) {
+            yylhs.value.as < ArenaListBuilder<StatementNode*> > ().append(arena(), yystack_[0].value.as < StatementNode* > ());
         }
     }
-#line 1206 "parser.tab.cc"
+#line 1176 "parser.tab.cc"
     break;
 
   case 34: // statement_list: statement_list statement
-#line 204 "parser.y"
+#line 203 "parser.y"
                                {
-        yylhs.value.as < std::vector<std::unique_ptr<StatementNode>> > () = std::move(yystack_[1].value.as < std::vector<std::unique_ptr<StatementNode>> > ());
-        if (yystack_[0].value.as < std::unique_ptr<StatementNode> > ()) {
-            yylhs.value.as < std::vector<std::unique_ptr<StatementNode>> > ().push_back(std::move(yystack_[0].value.as < std::unique_ptr<StatementNode> > ()));
+        yylhs.value.as < ArenaListBuilder<StatementNode*> > () = yystack_[1].value.as < ArenaListBuilder<StatementNode*> > ();
+        if (yystack_[0].value.as < StatementNode* > ()) {
+            yylhs.value.as < ArenaListBuilder<StatementNode*> > ().append(arena(), yystack_[0].value.as < StatementNode* > ());
         }
     }
-#line 1217 "parser.tab.cc"
+#line 1187 "parser.tab.cc"
     break;
 
   case 35: // expression: INTEGER_LITERAL
-#line 213 "parser.y"
+#line 212 "parser.y"
                     {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<LiteralNode>(std::to_string(yystack_[0].value.as < int > ()), "int", yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<LiteralNode>(names().intern(std::to_string(yystack_[0].value.as < int > ())), "int", yylineno);
     }
-#line 1225 "parser.tab.cc"
+#line 1195 "parser.tab.cc"
     break;
 
   case 36: // expression: FLOAT_LITERAL
-#line 216 "parser.y"
+#line 215 "parser.y"
                     {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<LiteralNode>(take_owned_text(yystack_[0].value.as < char* > ()), "float", yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<LiteralNode>(yystack_[0].value.as < SymbolId > (), "float", yylineno);
     }
-#line 1233 "parser.tab.cc"
+#line 1203 "parser.tab.cc"
     break;
 
   case 37: // expression: STRING_LITERAL
-#line 219 "parser.y"
+#line 218 "parser.y"
                      {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<LiteralNode>(take_owned_text(yystack_[0].value.as < char* > ()), "string", yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<LiteralNode>(yystack_[0].value.as < SymbolId > (), "string", yylineno);
     }
-#line 1241 "parser.tab.cc"
+#line 1211 "parser.tab.cc"
     break;
 
   case 38: // expression: CHAR_LITERAL
-#line 222 "parser.y"
+#line 221 "parser.y"
                    {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<LiteralNode>(take_owned_text(yystack_[0].value.as < char* > ()), "char", yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<LiteralNode>(yystack_[0].value.as < SymbolId > (), "char", yylineno);
     }
-#line 1249 "parser.tab.cc"
+#line 1219 "parser.tab.cc"
     break;
 
   case 39: // expression: IDENTIFIER
-#line 225 "parser.y"
+#line 224 "parser.y"
                  {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<IdentifierNode>(take_owned_text(yystack_[0].value.as < char* > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<IdentifierNode>(yystack_[0].value.as < SymbolId > (), yylineno);
     }
-#line 1257 "parser.tab.cc"
+#line 1227 "parser.tab.cc"
     break;
 
   case 40: // expression: IDENTIFIER '(' expression_list ')'
-#line 228 "parser.y"
+#line 227 "parser.y"
                                          {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<CallNode>(take_owned_text(yystack_[3].value.as < char* > ()), std::move(yystack_[1].value.as < std::vector<std::unique_ptr<ExpressionNode>> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<CallNode>(yystack_[3].value.as < SymbolId > (), yystack_[1].value.as < ArenaListBuilder<ExpressionNode*> > ().finish(arena()), yylineno);
     }
-#line 1265 "parser.tab.cc"
+#line 1235 "parser.tab.cc"
     break;
 
   case 41: // expression: IDENTIFIER '(' ')'
-#line 231 "parser.y"
+#line 230 "parser.y"
                          {
-        std::vector<std::unique_ptr<ExpressionNode>> args;
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<CallNode>(take_owned_text(yystack_[2].value.as < char* > ()), std::move(args), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<CallNode>(yystack_[2].value.as < SymbolId > (), ArenaSpan<ExpressionNode*>(), yylineno);
     }
-#line 1274 "parser.tab.cc"
+#line 1243 "parser.tab.cc"
     break;
 
   case 42: // expression: '(' expression ')'
-#line 235 "parser.y"
+#line 233 "parser.y"
                          {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::move(yystack_[1].value.as < std::unique_ptr<ExpressionNode> > ());
+        yylhs.value.as < ExpressionNode* > () = yystack_[1].value.as < ExpressionNode* > ();
     }
-#line 1282 "parser.tab.cc"
+#line 1251 "parser.tab.cc"
     break;
 
   case 43: // expression: expression '+' expression
-#line 238 "parser.y"
+#line 236 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("+", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::ADD, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1290 "parser.tab.cc"
+#line 1259 "parser.tab.cc"
     break;
 
   case 44: // expression: expression '-' expression
-#line 241 "parser.y"
+#line 239 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("-", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::SUB, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1298 "parser.tab.cc"
+#line 1267 "parser.tab.cc"
     break;
 
   case 45: // expression: expression '*' expression
-#line 244 "parser.y"
+#line 242 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("*", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::MUL, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1306 "parser.tab.cc"
+#line 1275 "parser.tab.cc"
     break;
 
   case 46: // expression: expression '/' expression
-#line 247 "parser.y"
+#line 245 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("/", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::DIV, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1314 "parser.tab.cc"
+#line 1283 "parser.tab.cc"
     break;
 
   case 47: // expression: expression '%' expression
-#line 250 "parser.y"
+#line 248 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("%", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::MOD, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1322 "parser.tab.cc"
+#line 1291 "parser.tab.cc"
     break;
 
   case 48: // expression: expression EQ expression
-#line 253 "parser.y"
+#line 251 "parser.y"
                                {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("==", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::EQ, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1330 "parser.tab.cc"
+#line 1299 "parser.tab.cc"
     break;
 
   case 49: // expression: expression NE expression
-#line 256 "parser.y"
+#line 254 "parser.y"
                                {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("!=", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::NE, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1338 "parser.tab.cc"
+#line 1307 "parser.tab.cc"
     break;
 
   case 50: // expression: expression '<' expression
-#line 259 "parser.y"
+#line 257 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("<", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::LT, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1346 "parser.tab.cc"
+#line 1315 "parser.tab.cc"
     break;
 
   case 51: // expression: expression '>' expression
-#line 262 "parser.y"
+#line 260 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>(">", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::GT, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1354 "parser.tab.cc"
+#line 1323 "parser.tab.cc"
     break;
 
   case 52: // expression: expression LE expression
-#line 265 "parser.y"
+#line 263 "parser.y"
                                {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("<=", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::LE, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1362 "parser.tab.cc"
+#line 1331 "parser.tab.cc"
     break;
 
   case 53: // expression: expression GE expression
-#line 268 "parser.y"
+#line 266 "parser.y"
                                {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>(">=", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::GE, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1370 "parser.tab.cc"
+#line 1339 "parser.tab.cc"
     break;
 
   case 54: // expression: expression AND expression
-#line 271 "parser.y"
+#line 269 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("&&", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::AND, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1378 "parser.tab.cc"
+#line 1347 "parser.tab.cc"
     break;
 
   case 55: // expression: expression OR expression
-#line 274 "parser.y"
+#line 272 "parser.y"
                                {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("||", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::OR, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1386 "parser.tab.cc"
+#line 1355 "parser.tab.cc"
     break;
 
   case 56: // expression: '!' expression
-#line 277 "parser.y"
+#line 275 "parser.y"
                      {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<UnaryOpNode>("!", std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<UnaryOpNode>(Operator::NOT, yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1394 "parser.tab.cc"
+#line 1363 "parser.tab.cc"
     break;
 
   case 57: // expression: '-' expression
-#line 280 "parser.y"
+#line 278 "parser.y"
                      {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<UnaryOpNode>("-", std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<UnaryOpNode>(Operator::NEG, yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1402 "parser.tab.cc"
+#line 1371 "parser.tab.cc"
     break;
 
   case 58: // expression: '+' expression
-#line 283 "parser.y"
+#line 281 "parser.y"
                      {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<UnaryOpNode>("+", std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<UnaryOpNode>(Operator::PLUS, yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1410 "parser.tab.cc"
+#line 1379 "parser.tab.cc"
     break;
 
   case 59: // expression: expression '=' expression
-#line 286 "parser.y"
+#line 284 "parser.y"
                                 {
-        yylhs.value.as < std::unique_ptr<ExpressionNode> > () = std::make_unique<BinaryOpNode>("=", std::move(yystack_[2].value.as < std::unique_ptr<ExpressionNode> > ()), std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()), yylineno);
+        yylhs.value.as < ExpressionNode* > () = arena().make<BinaryOpNode>(Operator::ASSIGN, yystack_[2].value.as < ExpressionNode* > (), yystack_[0].value.as < ExpressionNode* > (), yylineno);
     }
-#line 1418 "parser.tab.cc"
+#line 1387 "parser.tab.cc"
     break;
 
   case 60: // expression_list: expression
-#line 292 "parser.y"
+#line 290 "parser.y"
                {
-        yylhs.value.as < std::vector<std::unique_ptr<ExpressionNode>> > () = std::vector<std::unique_ptr<ExpressionNode>>();
-        yylhs.value.as < std::vector<std::unique_ptr<ExpressionNode>> > ().push_back(std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()));
+        yylhs.value.as < ArenaListBuilder<ExpressionNode*> > () = ArenaListBuilder<ExpressionNode*>();
+        yylhs.value.as < ArenaListBuilder<ExpressionNode*> > ().append(arena(), yystack_[0].value.as < ExpressionNode* > ());
     }
-#line 1427 "parser.tab.cc"
+#line 1396 "parser.tab.cc"
     break;
 
   case 61: // expression_list: expression_list ',' expression
-#line 296 "parser.y"
+#line 294 "parser.y"
                                      {
-        yylhs.value.as < std::vector<std::unique_ptr<ExpressionNode>> > () = std::move(yystack_[2].value.as < std::vector<std::unique_ptr<ExpressionNode>> > ());
-        yylhs.value.as < std::vector<std::unique_ptr<ExpressionNode>> > ().push_back(std::move(yystack_[0].value.as < std::unique_ptr<ExpressionNode> > ()));
+        yylhs.value.as < ArenaListBuilder<ExpressionNode*> > () = yystack_[2].value.as < ArenaListBuilder<ExpressionNode*> > ();
+        yylhs.value.as < ArenaListBuilder<ExpressionNode*> > ().append(arena(), yystack_[0].value.as < ExpressionNode* > ());
     }
-#line 1436 "parser.tab.cc"
+#line 1405 "parser.tab.cc"
     break;
 
 
-#line 1440 "parser.tab.cc"
+#line 1409 "parser.tab.cc"
 
             default:
               break;
@@ -2050,13 +2019,13 @@ namespace yy {
   const short
   parser::yyrline_[] =
   {
-       0,    72,    72,    76,    77,    78,    82,    85,    92,    96,
-     103,   109,   112,   118,   119,   120,   121,   122,   126,   130,
-     133,   140,   151,   158,   165,   168,   171,   174,   177,   180,
-     183,   189,   192,   198,   204,   213,   216,   219,   222,   225,
-     228,   231,   235,   238,   241,   244,   247,   250,   253,   256,
-     259,   262,   265,   268,   271,   274,   277,   280,   283,   286,
-     292,   296
+       0,    92,    92,    96,    97,    98,   102,   105,   111,   115,
+     122,   128,   131,   137,   138,   139,   140,   141,   145,   149,
+     152,   155,   158,   161,   164,   167,   170,   173,   176,   179,
+     182,   188,   191,   197,   203,   212,   215,   218,   221,   224,
+     227,   230,   233,   236,   239,   242,   245,   248,   251,   254,
+     257,   260,   263,   266,   269,   272,   275,   278,   281,   284,
+     290,   294
   };
 
   void
@@ -2139,9 +2108,9 @@ namespace yy {
   }
 
 } // yy
-#line 2143 "parser.tab.cc"
+#line 2112 "parser.tab.cc"
 
-#line 302 "parser.y"
+#line 300 "parser.y"
 
 
 void yy::parser::error(const location_type& loc, const std::string& msg) {
@@ -45,16 +45,18 @@
 #ifndef YY_YY_PARSER_TAB_HH_INCLUDED
 # define YY_YY_PARSER_TAB_HH_INCLUDED
 // "%code requires" blocks.
-#line 6 "parser.y"
+#line 11 "parser.y"
 
 #include "ast.h"
-#include <memory>
-#include <vector>
+#include <cstdio>
+#include <string_view>
 
-// Global AST root - exported for main.cpp
-extern std::vector<std::unique_ptr<StatementNode>> g_ast;
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
 
-#line 58 "parser.tab.hh"
+#line 60 "parser.tab.hh"
 
 
 # include <cstdlib> // std::abort
@@ -189,7 +191,7 @@ extern std::vector<std::unique_ptr<StatementNode>> g_ast;
 #endif
 
 namespace yy {
-#line 193 "parser.tab.hh"
+#line 195 "parser.tab.hh"
 
 
 
@@ -385,38 +387,36 @@ namespace yy {
     /// An auxiliary type to compute the largest semantic type.
     union union_type
     {
-      // IDENTIFIER
-      // STRING_LITERAL
-      // CHAR_LITERAL
-      // FLOAT_LITERAL
-      char dummy1[sizeof (char*)];
-
-      // INTEGER_LITERAL
-      char dummy2[sizeof (int)];
+      // expression_list
+      char dummy1[sizeof (ArenaListBuilder<ExpressionNode*>)];
 
-      // parameter
-      char dummy3[sizeof (std::pair<std::string, std::string>)];
+      // parameter_list
+      char dummy2[sizeof (ArenaListBuilder<Parameter>)];
 
-      // type_specifier
-      char dummy4[sizeof (std::string)];
+      // statement_list
+      char dummy3[sizeof (ArenaListBuilder<StatementNode*>)];
 
       // block
-      char dummy5[sizeof (std::unique_ptr<BlockNode>)];
+      char dummy4[sizeof (BlockNode*)];
 
       // expression
-      char dummy6[sizeof (std::unique_ptr<ExpressionNode>)];
+      char dummy5[sizeof (ExpressionNode*)];
 
-      // statement
-      char dummy7[sizeof (std::unique_ptr<StatementNode>)];
+      // parameter
+      char dummy6[sizeof (Parameter)];
 
-      // parameter_list
-      char dummy8[sizeof (std::vector<std::pair<std::string, std::string>>)];
+      // statement
+      char dummy7[sizeof (StatementNode*)];
 
-      // expression_list
-      char dummy9[sizeof (std::vector<std::unique_ptr<ExpressionNode>>)];
+      // IDENTIFIER
+      // STRING_LITERAL
+      // CHAR_LITERAL
+      // FLOAT_LITERAL
+      // type_specifier
+      char dummy8[sizeof (SymbolId)];
 
-      // statement_list
-      char dummy10[sizeof (std::vector<std::unique_ptr<StatementNode>>)];
+      // INTEGER_LITERAL
+      char dummy9[sizeof (int)];
     };
 
     /// The size of the largest semantic type.
@@ -650,47 +650,44 @@ namespace yy {
       {
         switch (this->kind ())
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.move< char* > (std::move (that.value));
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.move< int > (std::move (that.value));
+      case symbol_kind::S_expression_list: // expression_list
+        value.move< ArenaListBuilder<ExpressionNode*> > (std::move (that.value));
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.move< std::pair<std::string, std::string> > (std::move (that.value));
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.move< ArenaListBuilder<Parameter> > (std::move (that.value));
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.move< std::string > (std::move (that.value));
+      case symbol_kind::S_statement_list: // statement_list
+        value.move< ArenaListBuilder<StatementNode*> > (std::move (that.value));
         break;
 
       case symbol_kind::S_block: // block
-        value.move< std::unique_ptr<BlockNode> > (std::move (that.value));
+        value.move< BlockNode* > (std::move (that.value));
         break;
 
       case symbol_kind::S_expression: // expression
-        value.move< std::unique_ptr<ExpressionNode> > (std::move (that.value));
+        value.move< ExpressionNode* > (std::move (that.value));
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.move< std::unique_ptr<StatementNode> > (std::move (that.value));
+      case symbol_kind::S_parameter: // parameter
+        value.move< Parameter > (std::move (that.value));
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.move< std::vector<std::pair<std::string, std::string>> > (std::move (that.value));
+      case symbol_kind::S_statement: // statement
+        value.move< StatementNode* > (std::move (that.value));
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.move< std::vector<std::unique_ptr<ExpressionNode>> > (std::move (that.value));
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.move< SymbolId > (std::move (that.value));
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.move< std::vector<std::unique_ptr<StatementNode>> > (std::move (that.value));
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.move< int > (std::move (that.value));
         break;
 
       default:
@@ -717,13 +714,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, char*&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, ArenaListBuilder<ExpressionNode*>&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const char*& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const ArenaListBuilder<ExpressionNode*>& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -731,13 +728,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, int&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, ArenaListBuilder<Parameter>&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const int& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const ArenaListBuilder<Parameter>& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -745,13 +742,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::pair<std::string, std::string>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, ArenaListBuilder<StatementNode*>&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::pair<std::string, std::string>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const ArenaListBuilder<StatementNode*>& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -759,13 +756,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::string&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, BlockNode*&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::string& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const BlockNode*& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -773,13 +770,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::unique_ptr<BlockNode>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, ExpressionNode*&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::unique_ptr<BlockNode>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const ExpressionNode*& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -787,13 +784,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::unique_ptr<ExpressionNode>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, Parameter&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::unique_ptr<ExpressionNode>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const Parameter& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -801,13 +798,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::unique_ptr<StatementNode>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, StatementNode*&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::unique_ptr<StatementNode>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const StatementNode*& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -815,13 +812,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::vector<std::pair<std::string, std::string>>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, SymbolId&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::vector<std::pair<std::string, std::string>>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const SymbolId& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -829,27 +826,13 @@ namespace yy {
 #endif
 
 #if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::vector<std::unique_ptr<ExpressionNode>>&& v, location_type&& l)
-        : Base (t)
-        , value (std::move (v))
-        , location (std::move (l))
-      {}
-#else
-      basic_symbol (typename Base::kind_type t, const std::vector<std::unique_ptr<ExpressionNode>>& v, const location_type& l)
-        : Base (t)
-        , value (v)
-        , location (l)
-      {}
-#endif
-
-#if 201103L <= YY_CPLUSPLUS
-      basic_symbol (typename Base::kind_type t, std::vector<std::unique_ptr<StatementNode>>&& v, location_type&& l)
+      basic_symbol (typename Base::kind_type t, int&& v, location_type&& l)
         : Base (t)
         , value (std::move (v))
         , location (std::move (l))
       {}
 #else
-      basic_symbol (typename Base::kind_type t, const std::vector<std::unique_ptr<StatementNode>>& v, const location_type& l)
+      basic_symbol (typename Base::kind_type t, const int& v, const location_type& l)
         : Base (t)
         , value (v)
         , location (l)
@@ -880,47 +863,44 @@ namespace yy {
         // Value type destructor.
 switch (yykind)
     {
-      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
-      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
-      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
-      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
-        value.template destroy< char* > ();
-        break;
-
-      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
-        value.template destroy< int > ();
+      case symbol_kind::S_expression_list: // expression_list
+        value.template destroy< ArenaListBuilder<ExpressionNode*> > ();
         break;
 
-      case symbol_kind::S_parameter: // parameter
-        value.template destroy< std::pair<std::string, std::string> > ();
+      case symbol_kind::S_parameter_list: // parameter_list
+        value.template destroy< ArenaListBuilder<Parameter> > ();
         break;
 
-      case symbol_kind::S_type_specifier: // type_specifier
-        value.template destroy< std::string > ();
+      case symbol_kind::S_statement_list: // statement_list
+        value.template destroy< ArenaListBuilder<StatementNode*> > ();
         break;
 
       case symbol_kind::S_block: // block
-        value.template destroy< std::unique_ptr<BlockNode> > ();
+        value.template destroy< BlockNode* > ();
         break;
 
       case symbol_kind::S_expression: // expression
-        value.template destroy< std::unique_ptr<ExpressionNode> > ();
+        value.template destroy< ExpressionNode* > ();
         break;
 
-      case symbol_kind::S_statement: // statement
-        value.template destroy< std::unique_ptr<StatementNode> > ();
+      case symbol_kind::S_parameter: // parameter
+        value.template destroy< Parameter > ();
         break;
 
-      case symbol_kind::S_parameter_list: // parameter_list
-        value.template destroy< std::vector<std::pair<std::string, std::string>> > ();
+      case symbol_kind::S_statement: // statement
+        value.template destroy< StatementNode* > ();
         break;
 
-      case symbol_kind::S_expression_list: // expression_list
-        value.template destroy< std::vector<std::unique_ptr<ExpressionNode>> > ();
+      case symbol_kind::S_IDENTIFIER: // IDENTIFIER
+      case symbol_kind::S_STRING_LITERAL: // STRING_LITERAL
+      case symbol_kind::S_CHAR_LITERAL: // CHAR_LITERAL
+      case symbol_kind::S_FLOAT_LITERAL: // FLOAT_LITERAL
+      case symbol_kind::S_type_specifier: // type_specifier
+        value.template destroy< SymbolId > ();
         break;
 
-      case symbol_kind::S_statement_list: // statement_list
-        value.template destroy< std::vector<std::unique_ptr<StatementNode>> > ();
+      case symbol_kind::S_INTEGER_LITERAL: // INTEGER_LITERAL
+        value.template destroy< int > ();
         break;
 
       default:
@@ -1020,10 +1000,10 @@ switch (yykind)
 #endif
       {}
 #if 201103L <= YY_CPLUSPLUS
-      symbol_type (int tok, char* v, location_type l)
+      symbol_type (int tok, SymbolId v, location_type l)
         : super_type (token_kind_type (tok), std::move (v), std::move (l))
 #else
-      symbol_type (int tok, const char*& v, const location_type& l)
+      symbol_type (int tok, const SymbolId& v, const location_type& l)
         : super_type (token_kind_type (tok), v, l)
 #endif
       {}
@@ -1038,7 +1018,7 @@ switch (yykind)
     };
 
     /// Build a parser object.
-    parser ();
+    parser (yyscan_t scanner_yyarg, TranslationUnit& unit_yyarg);
     virtual ~parser ();
 
 #if 201103L <= YY_CPLUSPLUS
@@ -1146,14 +1126,14 @@ switch (yykind)
 #if 201103L <= YY_CPLUSPLUS
       static
       symbol_type
-      make_IDENTIFIER (char* v, location_type l)
+      make_IDENTIFIER (SymbolId v, location_type l)
       {
         return symbol_type (token::IDENTIFIER, std::move (v), std::move (l));
       }
 #else
       static
       symbol_type
-      make_IDENTIFIER (const char*& v, const location_type& l)
+      make_IDENTIFIER (const SymbolId& v, const location_type& l)
       {
         return symbol_type (token::IDENTIFIER, v, l);
       }
@@ -1161,14 +1141,14 @@ switch (yykind)
 #if 201103L <= YY_CPLUSPLUS
       static
       symbol_type
-      make_STRING_LITERAL (char* v, location_type l)
+      make_STRING_LITERAL (SymbolId v, location_type l)
       {
         return symbol_type (token::STRING_LITERAL, std::move (v), std::move (l));
       }
 #else
       static
       symbol_type
-      make_STRING_LITERAL (const char*& v, const location_type& l)
+      make_STRING_LITERAL (const SymbolId& v, const location_type& l)
       {
         return symbol_type (token::STRING_LITERAL, v, l);
       }
@@ -1176,14 +1156,14 @@ switch (yykind)
 #if 201103L <= YY_CPLUSPLUS
       static
       symbol_type
-      make_CHAR_LITERAL (char* v, location_type l)
+      make_CHAR_LITERAL (SymbolId v, location_type l)
       {
         return symbol_type (token::CHAR_LITERAL, std::move (v), std::move (l));
       }
 #else
       static
       symbol_type
-      make_CHAR_LITERAL (const char*& v, const location_type& l)
+      make_CHAR_LITERAL (const SymbolId& v, const location_type& l)
       {
         return symbol_type (token::CHAR_LITERAL, v, l);
       }
@@ -1191,14 +1171,14 @@ switch (yykind)
 #if 201103L <= YY_CPLUSPLUS
       static
       symbol_type
-      make_FLOAT_LITERAL (char* v, location_type l)
+      make_FLOAT_LITERAL (SymbolId v, location_type l)
       {
         return symbol_type (token::FLOAT_LITERAL, std::move (v), std::move (l));
       }
 #else
       static
       symbol_type
-      make_FLOAT_LITERAL (const char*& v, const location_type& l)
+      make_FLOAT_LITERAL (const SymbolId& v, const location_type& l)
       {
         return symbol_type (token::FLOAT_LITERAL, v, l);
       }
@@ -2184,20 +2164,28 @@ switch (yykind)
     };
 
 
+    // User arguments.
+    yyscan_t scanner;
+    TranslationUnit& unit;
 
   };
 
 
 } // yy
-#line 2193 "parser.tab.hh"
+#line 2176 "parser.tab.hh"
 
 
 // "%code provides" blocks.
-#line 15 "parser.y"
+#line 22 "parser.y"
 
-int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc);
+// Reentrant scanner interface generated from lexer.l
+int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc, yyscan_t scanner);
+int yylex_init_extra(TranslationUnit* unit, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
 
-#line 2201 "parser.tab.hh"
+#line 2189 "parser.tab.hh"
 
 
 #endif // !YY_YY_PARSER_TAB_HH_INCLUDED
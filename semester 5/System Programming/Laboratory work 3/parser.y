@@ -3,17 +3,29 @@
 %define parse.error verbose
 %locations
 
+// The parser and the scanner are reentrant: each parse gets its own scanner
+// handle and the TranslationUnit it fills, so files can be parsed in parallel
+%parse-param { yyscan_t scanner } { TranslationUnit& unit }
+%lex-param { yyscan_t scanner }
+
 %code requires {
 #include "ast.h"
-#include <memory>
-#include <vector>
+#include <cstdio>
+#include <string_view>
 
-// Global AST root - exported for main.cpp
-extern std::vector<std::unique_ptr<StatementNode>> g_ast;
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
 }
 
 %code provides {
-int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc);
+// Reentrant scanner interface generated from lexer.l
+int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc, yyscan_t scanner);
+int yylex_init_extra(TranslationUnit* unit, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
 }
 
 %{
@@ -22,22 +34,30 @@ int yylex(yy::parser::semantic_type* yylval, yy::parser::location_type* yylloc);
 #include <string.h>
 #include <string>
 
-extern int yylineno;
-extern FILE* yyin;
+%}
+
+%code {
+// Every node of the tree is allocated in the unit's arena
+#define arena() unit.getArena()
+
+// Identifiers, type names and literal spellings are interned in the unit
+#define names() unit.getNames()
 
-static std::string take_owned_text(char* text) {
-    if (!text) {
-        return std::string();
+// Line the scanner has reached, used as the line of the node being reduced
+#define yylineno yyget_lineno(scanner)
+
+// Wraps a single statement (or nothing) into a block for if/while/for bodies
+static BlockNode* wrap_in_block(Arena& arena, StatementNode* stmt) {
+    ArenaListBuilder<StatementNode*> statements;
+    if (stmt) {
+        statements.append(arena, stmt);
     }
-    std::string result(text);
-    free(text);
-    return result;
+    return arena.make<BlockNode>(statements.finish(arena));
+}
 }
-
-%}
 
 %token <int> INTEGER_LITERAL
-%token <char*> IDENTIFIER STRING_LITERAL CHAR_LITERAL FLOAT_LITERAL
+%token <SymbolId> IDENTIFIER STRING_LITERAL CHAR_LITERAL FLOAT_LITERAL
 %token INT CHAR FLOAT_TYPE DOUBLE VOID
 %token IF ELSE WHILE FOR RETURN BREAK CONTINUE DO SWITCH CASE DEFAULT
 %token STRUCT TYPEDEF CONST STATIC EXTERN SIZEOF
@@ -46,14 +66,14 @@ static std::string take_owned_text(char* text) {
 %token LSHIFT_ASSIGN RSHIFT_ASSIGN AND_ASSIGN OR_ASSIGN XOR_ASSIGN
 %token LSHIFT RSHIFT ARROW
 
-%nterm <std::unique_ptr<ExpressionNode>> expression
-%nterm <std::unique_ptr<StatementNode>> statement
-%nterm <std::unique_ptr<BlockNode>> block
-%nterm <std::vector<std::unique_ptr<StatementNode>>> statement_list
-%nterm <std::vector<std::unique_ptr<ExpressionNode>>> expression_list
-%nterm <std::pair<std::string, std::string>> parameter
-%nterm <std::vector<std::pair<std::string, std::string>>> parameter_list
-%nterm <std::string> type_specifier
+%nterm <ExpressionNode*> expression
+%nterm <StatementNode*> statement
+%nterm <BlockNode*> block
+%nterm <ArenaListBuilder<StatementNode*>> statement_list
+%nterm <ArenaListBuilder<ExpressionNode*>> expression_list
+%nterm <Parameter> parameter
+%nterm <ArenaListBuilder<Parameter>> parameter_list
+%nterm <SymbolId> type_specifier
 
 %left OR
 %left AND
@@ -80,46 +100,45 @@ translation_unit:
 
 function_definition:
     type_specifier IDENTIFIER '(' parameter_list ')' block {
-        g_ast.push_back(std::make_unique<FunctionNode>(take_owned_text($2), $1, std::move($4), std::move($6), yylineno));
+        unit.add(arena().make<FunctionNode>($2, $1, $4.finish(arena()), $6, yylineno));
     }
     | type_specifier IDENTIFIER '(' ')' block {
-        std::vector<std::pair<std::string, std::string>> params;
-        g_ast.push_back(std::make_unique<FunctionNode>(take_owned_text($2), $1, std::move(params), std::move($5), yylineno));
+        unit.add(arena().make<FunctionNode>($2, $1, ArenaSpan<Parameter>(), $5, yylineno));
     }
     ;
 
 parameter_list:
     parameter {
-        $$ = std::vector<std::pair<std::string, std::string>>();
-        $$.push_back($1);
+        $$ = ArenaListBuilder<Parameter>();
+        $$.append(arena(), $1);
     }
     | parameter_list ',' parameter {
-        $$ = std::move($1);
-        $$.push_back($3);
+        $$ = $1;
+        $$.append(arena(), $3);
     }
     ;
 
 parameter:
     type_specifier IDENTIFIER {
-        $$ = std::make_pair($1, take_owned_text($2));
+        $$ = Parameter{$1, $2};
     }
     ;
 
 declaration:
     type_specifier IDENTIFIER ';' {
-        g_ast.push_back(std::make_unique<VarDeclNode>($1, take_owned_text($2), nullptr, yylineno));
+        unit.add(arena().make<VarDeclNode>($1, $2, nullptr, yylineno));
     }
     | type_specifier IDENTIFIER '=' expression ';' {
-        g_ast.push_back(std::make_unique<VarDeclNode>($1, take_owned_text($2), std::move($4), yylineno));
+        unit.add(arena().make<VarDeclNode>($1, $2, $4, yylineno));
     }
     ;
 
 type_specifier:
-    INT { $$ = "int"; }
-    | CHAR { $$ = "char"; }
-    | FLOAT_TYPE { $$ = "float"; }
-    | DOUBLE { $$ = "double"; }
-    | VOID { $$ = "void"; }
+    INT { $$ = names().intern("int"); }
+    | CHAR { $$ = names().intern("char"); }
+    | FLOAT_TYPE { $$ = names().intern("float"); }
+    | DOUBLE { $$ = names().intern("double"); }
+    | VOID { $$ = names().intern("void"); }
     ;
 
 statement:
@@ -128,174 +147,153 @@ statement:
         $$ = nullptr;
     }
     | block {
-        $$ = std::move($1);
+        $$ = $1;
     }
     | IF '(' expression ')' statement {
-        std::unique_ptr<BlockNode> thenBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if ($5) {
-            thenBlock->getStatements().push_back(std::move($5));
-        }
-        $$ = std::make_unique<IfNode>(std::move($3), std::move(thenBlock), nullptr, yylineno);
+        $$ = arena().make<IfNode>($3, wrap_in_block(arena(), $5), nullptr, yylineno);
     }
     | IF '(' expression ')' statement ELSE statement {
-        std::unique_ptr<BlockNode> thenBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        std::unique_ptr<BlockNode> elseBlock = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if ($5) {
-            thenBlock->getStatements().push_back(std::move($5));
-        }
-        if ($7) {
-            elseBlock->getStatements().push_back(std::move($7));
-        }
-        $$ = std::make_unique<IfNode>(std::move($3), std::move(thenBlock), std::move(elseBlock), yylineno);
+        $$ = arena().make<IfNode>($3, wrap_in_block(arena(), $5), wrap_in_block(arena(), $7), yylineno);
     }
     | WHILE '(' expression ')' statement {
-        std::unique_ptr<BlockNode> body = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if ($5) {
-            body->getStatements().push_back(std::move($5));
-        }
-        $$ = std::make_unique<WhileNode>(std::move($3), std::move(body), yylineno);
+        $$ = arena().make<WhileNode>($3, wrap_in_block(arena(), $5), yylineno);
     }
     | FOR '(' expression ';' expression ';' expression ')' statement {
-        std::unique_ptr<BlockNode> body = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>());
-        if ($9) {
-            body->getStatements().push_back(std::move($9));
-        }
-        $$ = std::make_unique<ForNode>(nullptr, std::move($5), std::move($7), std::move(body), yylineno);
+        $$ = arena().make<ForNode>(nullptr, $5, $7, wrap_in_block(arena(), $9), yylineno);
     }
     | RETURN ';' {
-        $$ = std::make_unique<ReturnNode>(nullptr, yylineno);
+        $$ = arena().make<ReturnNode>(nullptr, yylineno);
     }
     | RETURN expression ';' {
-        $$ = std::make_unique<ReturnNode>(std::move($2), yylineno);
+        $$ = arena().make<ReturnNode>($2, yylineno);
     }
     | BREAK ';' {
-        $$ = std::make_unique<BreakNode>(yylineno);
+        $$ = arena().make<BreakNode>(yylineno);
     }
     | CONTINUE ';' {
-        $$ = std::make_unique<ContinueNode>(yylineno);
+        $$ = arena().make<ContinueNode>(yylineno);
     }
     | type_specifier IDENTIFIER ';' {
-        $$ = std::make_unique<VarDeclNode>($1, take_owned_text($2), nullptr, yylineno);
+        $$ = arena().make<VarDeclNode>($1, $2, nullptr, yylineno);
     }
     | type_specifier IDENTIFIER '=' expression ';' {
-        $$ = std::make_unique<VarDeclNode>($1, take_owned_text($2), std::move($4), yylineno);
+        $$ = arena().make<VarDeclNode>($1, $2, $4, yylineno);
     }
     | IDENTIFIER '=' expression ';' {
-        $$ = std::make_unique<AssignNode>(take_owned_text($1), std::move($3), yylineno);
+        $$ = arena().make<AssignNode>($1, $3, yylineno);
     }
     ;
 
 block:
     '{' statement_list '}' {
-        $$ = std::make_unique<BlockNode>(std::move($2), yylineno);
+        $$ = arena().make<BlockNode>($2.finish(arena()), yylineno);
     }
     | '{' '}' {
-        $$ = std::make_unique<BlockNode>(std::vector<std::unique_ptr<StatementNode>>(), yylineno);
+        $$ = arena().make<BlockNode>(ArenaSpan<StatementNode*>(), yylineno);
     }
     ;
 
 statement_list:
     statement {
-        $$ = std::vector<std::unique_ptr<StatementNode>>();
+        $$ = ArenaListBuilder<StatementNode*>();
         if ($1) {
-            $$.push_back(std::move($1));
+            $$.append(arena(), $1);
         }
     }
     | statement_list statement {
-        $$ = std::move($1);
+        $$ = $1;
         if ($2) {
-            $$.push_back(std::move($2));
+            $$.append(arena(), $2);
         }
     }
     ;
 
 expression:
     INTEGER_LITERAL {
-        $$ = std::make_unique<LiteralNode>(std::to_string($1), "int", yylineno);
+        $$ = arena().make<LiteralNode>(names().intern(std::to_string($1)), "int", yylineno);
     }
     | FLOAT_LITERAL {
-        $$ = std::make_unique<LiteralNode>(take_owned_text($1), "float", yylineno);
+        $$ = arena().make<LiteralNode>($1, "float", yylineno);
     }
     | STRING_LITERAL {
-        $$ = std::make_unique<LiteralNode>(take_owned_text($1), "string", yylineno);
+        $$ = arena().make<LiteralNode>($1, "string", yylineno);
     }
     | CHAR_LITERAL {
-        $$ = std::make_unique<LiteralNode>(take_owned_text($1), "char", yylineno);
+        $$ = arena().make<LiteralNode>($1, "char", yylineno);
     }
     | IDENTIFIER {
-        $$ = std::make_unique<IdentifierNode>(take_owned_text($1), yylineno);
+        $$ = arena().make<IdentifierNode>($1, yylineno);
     }
     | IDENTIFIER '(' expression_list ')' {
-        $$ = std::make_unique<CallNode>(take_owned_text($1), std::move($3), yylineno);
+        $$ = arena().make<CallNode>($1, $3.finish(arena()), yylineno);
     }
     | IDENTIFIER '(' ')' {
-        std::vector<std::unique_ptr<ExpressionNode>> args;
-        $$ = std::make_unique<CallNode>(take_owned_text($1), std::move(args), yylineno);
+        $$ = arena().make<CallNode>($1, ArenaSpan<ExpressionNode*>(), yylineno);
     }
     | '(' expression ')' {
-        $$ = std::move($2);
+        $$ = $2;
     }
     | expression '+' expression {
-        $$ = std::make_unique<BinaryOpNode>("+", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::ADD, $1, $3, yylineno);
     }
     | expression '-' expression {
-        $$ = std::make_unique<BinaryOpNode>("-", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::SUB, $1, $3, yylineno);
     }
     | expression '*' expression {
-        $$ = std::make_unique<BinaryOpNode>("*", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::MUL, $1, $3, yylineno);
     }
     | expression '/' expression {
-        $$ = std::make_unique<BinaryOpNode>("/", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::DIV, $1, $3, yylineno);
     }
     | expression '%' expression {
-        $$ = std::make_unique<BinaryOpNode>("%", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::MOD, $1, $3, yylineno);
     }
     | expression EQ expression {
-        $$ = std::make_unique<BinaryOpNode>("==", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::EQ, $1, $3, yylineno);
     }
     | expression NE expression {
-        $$ = std::make_unique<BinaryOpNode>("!=", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::NE, $1, $3, yylineno);
     }
     | expression '<' expression {
-        $$ = std::make_unique<BinaryOpNode>("<", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::LT, $1, $3, yylineno);
     }
     | expression '>' expression {
-        $$ = std::make_unique<BinaryOpNode>(">", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::GT, $1, $3, yylineno);
     }
     | expression LE expression {
-        $$ = std::make_unique<BinaryOpNode>("<=", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::LE, $1, $3, yylineno);
     }
     | expression GE expression {
-        $$ = std::make_unique<BinaryOpNode>(">=", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::GE, $1, $3, yylineno);
     }
     | expression AND expression {
-        $$ = std::make_unique<BinaryOpNode>("&&", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::AND, $1, $3, yylineno);
     }
     | expression OR expression {
-        $$ = std::make_unique<BinaryOpNode>("||", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::OR, $1, $3, yylineno);
     }
     | '!' expression {
-        $$ = std::make_unique<UnaryOpNode>("!", std::move($2), yylineno);
+        $$ = arena().make<UnaryOpNode>(Operator::NOT, $2, yylineno);
     }
     | '-' expression {
-        $$ = std::make_unique<UnaryOpNode>("-", std::move($2), yylineno);
+        $$ = arena().make<UnaryOpNode>(Operator::NEG, $2, yylineno);
     }
     | '+' expression {
-        $$ = std::make_unique<UnaryOpNode>("+", std::move($2), yylineno);
+        $$ = arena().make<UnaryOpNode>(Operator::PLUS, $2, yylineno);
     }
     | expression '=' expression {
-        $$ = std::make_unique<BinaryOpNode>("=", std::move($1), std::move($3), yylineno);
+        $$ = arena().make<BinaryOpNode>(Operator::ASSIGN, $1, $3, yylineno);
     }
     ;
 
 expression_list:
     expression {
-        $$ = std::vector<std::unique_ptr<ExpressionNode>>();
-        $$.push_back(std::move($1));
+        $$ = ArenaListBuilder<ExpressionNode*>();
+        $$.append(arena(), $1);
     }
     | expression_list ',' expression {
-        $$ = std::move($1);
-        $$.push_back(std::move($3));
+        $$ = $1;
+        $$.append(arena(), $3);
     }
     ;
 
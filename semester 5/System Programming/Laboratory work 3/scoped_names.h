@@ -0,0 +1,91 @@
+#ifndef SCOPED_NAMES_H
+#define SCOPED_NAMES_H
+
+#include <cstdint>
+#include <vector>
+#include "interner.h"
+
+// Maps each name to a T under block scoping, for the passes that resolve
+// names as they walk a function.
+// All scopes share one table indexed by SymbolId that holds the innermost
+// declaration of each name; a declaration that hides an outer one keeps the
+// index of the hidden one, so the outer value comes back when its scope is
+// left. Declarations are appended to a single log and a scope is just the log
+// length at enterScope(), so entering a scope allocates nothing, lookup is
+// one index, and exitScope() costs one step per name the scope declared.
+template <typename T>
+class ScopedNames {
+public:
+    // Drops every declaration and scope; nameCount sizes the table for the
+    // interner the names will come from
+    void reset(size_t nameCount) {
+        entries.clear();
+        scopeStarts.clear();
+        innermost.assign(nameCount, NONE);
+    }
+
+    bool hasScope() const { return !scopeStarts.empty(); }
+
+    void enterScope() {
+        scopeStarts.push_back(static_cast<uint32_t>(entries.size()));
+    }
+
+    void exitScope() {
+        if (scopeStarts.empty()) {
+            return;
+        }
+
+        // Undo the scope's declarations, newest first, uncovering what they hid
+        uint32_t start = scopeStarts.back();
+        scopeStarts.pop_back();
+        while (entries.size() > start) {
+            const Entry& entry = entries.back();
+            innermost[entry.name] = entry.shadowed;
+            entries.pop_back();
+        }
+    }
+
+    // Declares name in the current scope, hiding any outer declaration
+    void declare(SymbolId name, const T& value) {
+        if (name >= innermost.size()) {
+            innermost.resize(name + 1, NONE);
+        }
+        entries.push_back(Entry{value, name, innermost[name]});
+        innermost[name] = static_cast<uint32_t>(entries.size() - 1);
+    }
+
+    // Innermost declaration of name, or null; valid until the next declare()
+    T* find(SymbolId name) {
+        if (name >= innermost.size() || innermost[name] == NONE) {
+            return nullptr;
+        }
+        return &entries[innermost[name]].value;
+    }
+    const T* find(SymbolId name) const {
+        return const_cast<ScopedNames*>(this)->find(name);
+    }
+
+    bool isInCurrentScope(SymbolId name) const {
+        if (scopeStarts.empty() || name >= innermost.size()) {
+            return false;
+        }
+        // Entries of the current scope are the ones logged since it opened
+        uint32_t index = innermost[name];
+        return index != NONE && index >= scopeStarts.back();
+    }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Entry {
+        T value;
+        SymbolId name;
+        uint32_t shadowed;              // Entry this one hides, or NONE
+    };
+
+    std::vector<Entry> entries;         // Declarations in order; the undo log
+    std::vector<uint32_t> innermost;    // Indexed by SymbolId, NONE if undeclared
+    std::vector<uint32_t> scopeStarts;  // entries.size() when each scope opened
+};
+
+#endif // SCOPED_NAMES_H
@@ -1,57 +1,46 @@
 #include "semantic.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
-void SymbolTable::enterScope() {
-    scopes.push_back(std::unordered_map<std::string, Symbol>());
+static bool isArithmetic(TypeId type) {
+    return type >= TypeId::CHAR;
 }
 
-void SymbolTable::exitScope() {
-    if (!scopes.empty()) {
-        scopes.pop_back();
-    }
+static bool isInteger(TypeId type) {
+    return type == TypeId::CHAR || type == TypeId::INT;
+}
+
+// Usual arithmetic conversions: char becomes int, otherwise the wider type
+static TypeId promote(TypeId left, TypeId right) {
+    return std::max({left, right, TypeId::INT});
 }
 
-bool SymbolTable::addSymbol(const std::string& name, SymbolType type, const std::string& dataType) {
-    if (scopes.empty()) {
-        enterScope();
+bool SymbolTable::addSymbol(SymbolId name, SymbolType type, TypeId dataType) {
+    if (!scopes.hasScope()) {
+        scopes.enterScope();
     }
     
-    if (isInCurrentScope(name)) {
+    if (scopes.isInCurrentScope(name)) {
         return false; // Symbol already exists in current scope
     }
     
-    scopes.back()[name] = Symbol(type, name, dataType);
+    scopes.declare(name, Symbol(type, name, dataType));
     return true;
 }
 
-Symbol* SymbolTable::lookup(const std::string& name) {
-    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-        auto found = it->find(name);
-        if (found != it->end()) {
-            return &found->second;
-        }
-    }
-    return nullptr;
-}
+SemanticAnalyzer::SemanticAnalyzer() : names(nullptr), returnType(TypeId::UNKNOWN) {}
 
-bool SymbolTable::isInCurrentScope(const std::string& name) {
-    if (scopes.empty()) {
-        return false;
-    }
-    return scopes.back().find(name) != scopes.back().end();
-}
-
-SemanticAnalyzer::SemanticAnalyzer() {
-    symbolTable.enterScope();
-}
-
-bool SemanticAnalyzer::analyze(std::vector<std::unique_ptr<StatementNode>>& ast) {
+bool SemanticAnalyzer::analyze(const TranslationUnit& unit) {
+    names = &unit.getNames();
     errors.clear();
+    // Symbols are keyed by the unit's SymbolIds
+    symbolTable.reset(names->size());
+    symbolTable.enterScope();
     bool hasErrors = false;
     
-    for (auto& stmt : ast) {
-        analyzeStatement(stmt.get());
+    for (StatementNode* stmt : unit.getStatements()) {
+        analyzeStatement(stmt);
     }
     
     return errors.empty();
@@ -83,6 +72,8 @@ void SemanticAnalyzer::analyzeStatement(StatementNode* stmt) {
             analyzeBlock(static_cast<BlockNode*>(stmt));
             break;
         case ASTNode::NODE_RETURN:
+            analyzeReturn(static_cast<ReturnNode*>(stmt));
+            break;
         case ASTNode::NODE_BREAK:
         case ASTNode::NODE_CONTINUE:
             // No semantic analysis needed
@@ -92,41 +83,157 @@ void SemanticAnalyzer::analyzeStatement(StatementNode* stmt) {
     }
 }
 
-void SemanticAnalyzer::analyzeExpression(ExpressionNode* expr) {
-    if (!expr) return;
+TypeId SemanticAnalyzer::analyzeExpression(ExpressionNode* expr) {
+    if (!expr) return TypeId::UNKNOWN;
     
+    TypeId type = TypeId::UNKNOWN;
     switch (expr->getType()) {
         case ASTNode::NODE_IDENTIFIER: {
             IdentifierNode* id = static_cast<IdentifierNode*>(expr);
             Symbol* sym = symbolTable.lookup(id->getName());
             if (!sym) {
                 std::ostringstream oss;
-                oss << "Line " << expr->getLine() << ": Undefined identifier '" << id->getName() << "'\n";
+                oss << "Line " << expr->getLine() << ": Undefined identifier '" << text(id->getName()) << "'\n";
                 errors += oss.str();
+            } else if (sym->type == SymbolType::VARIABLE) {
+                type = sym->dataType;
             }
             break;
         }
         case ASTNode::NODE_CALL:
-            analyzeCall(static_cast<CallNode*>(expr));
+            type = analyzeCall(static_cast<CallNode*>(expr));
             break;
         case ASTNode::NODE_BINARY_OP:
+            type = analyzeBinaryOp(static_cast<BinaryOpNode*>(expr));
+            break;
         case ASTNode::NODE_UNARY_OP:
+            type = analyzeUnaryOp(static_cast<UnaryOpNode*>(expr));
+            break;
         case ASTNode::NODE_LITERAL:
-            // Type checking can be added here
+            // Set from the literal's kind when it was built
+            return expr->getResolvedType();
+        default:
+            break;
+    }
+    
+    expr->setResolvedType(type);
+    return type;
+}
+
+TypeId SemanticAnalyzer::analyzeBinaryOp(BinaryOpNode* binary) {
+    TypeId left = analyzeExpression(binary->getLeft());
+    TypeId right = analyzeExpression(binary->getRight());
+    Operator op = binary->getOp();
+    
+    if (op == Operator::ASSIGN) {
+        checkAssignment(left, right, binary->getLine(), "the left operand");
+        return left;
+    }
+    
+    // Comparisons and logical operators give int whatever the operands;
+    // an arithmetic result with a bad or unknown operand stays unknown so
+    // the error is not reported again by every enclosing expression
+    bool isArithmeticOp = op == Operator::ADD || op == Operator::SUB || op == Operator::MUL ||
+                          op == Operator::DIV || op == Operator::MOD;
+    TypeId invalid = isArithmeticOp ? TypeId::UNKNOWN : TypeId::INT;
+    if (left == TypeId::UNKNOWN || right == TypeId::UNKNOWN) {
+        return invalid;
+    }
+    
+    bool valid;
+    TypeId result;
+    switch (op) {
+        case Operator::MOD:
+            valid = isInteger(left) && isInteger(right);
+            result = TypeId::INT;
+            break;
+        case Operator::ADD:
+        case Operator::SUB:
+        case Operator::MUL:
+        case Operator::DIV:
+            valid = isArithmetic(left) && isArithmetic(right);
+            result = promote(left, right);
+            break;
+        case Operator::AND:
+        case Operator::OR:
+            valid = left != TypeId::VOID && right != TypeId::VOID;
+            result = TypeId::INT;
             break;
         default:
+            // Comparisons: two numbers or two strings
+            valid = (isArithmetic(left) && isArithmetic(right)) ||
+                    (left == TypeId::STRING && right == TypeId::STRING);
+            result = TypeId::INT;
             break;
     }
+    
+    if (!valid) {
+        std::ostringstream oss;
+        oss << "Line " << binary->getLine() << ": Invalid operands to binary '" << operatorSymbol(op)
+            << "' (" << typeName(left) << " and " << typeName(right) << ")\n";
+        errors += oss.str();
+        return invalid;
+    }
+    return result;
+}
+
+TypeId SemanticAnalyzer::analyzeUnaryOp(UnaryOpNode* unary) {
+    TypeId operand = analyzeExpression(unary->getOperand());
+    if (operand == TypeId::UNKNOWN) {
+        return unary->getOp() == Operator::NOT ? TypeId::INT : TypeId::UNKNOWN;
+    }
+    
+    bool isNot = unary->getOp() == Operator::NOT;
+    bool valid = isNot ? operand != TypeId::VOID : isArithmetic(operand);
+    if (!valid) {
+        std::ostringstream oss;
+        oss << "Line " << unary->getLine() << ": Invalid operand to unary '" << operatorSymbol(unary->getOp())
+            << "' (" << typeName(operand) << ")\n";
+        errors += oss.str();
+        return isNot ? TypeId::INT : TypeId::UNKNOWN;
+    }
+    return isNot ? TypeId::INT : promote(operand, TypeId::INT);
+}
+
+// Numbers convert to one another; strings and void go nowhere
+void SemanticAnalyzer::checkAssignment(TypeId target, TypeId value, int line, std::string_view what) {
+    if (target == TypeId::UNKNOWN || value == TypeId::UNKNOWN || target == value) {
+        return;
+    }
+    if (isArithmetic(target) && isArithmetic(value)) {
+        return;
+    }
+    
+    std::ostringstream oss;
+    oss << "Line " << line << ": Cannot assign " << typeName(value) << " to " << what
+        << " of type " << typeName(target) << "\n";
+    errors += oss.str();
+}
+
+void SemanticAnalyzer::analyzeCondition(ExpressionNode* condition) {
+    if (analyzeExpression(condition) == TypeId::VOID) {
+        std::ostringstream oss;
+        oss << "Line " << condition->getLine() << ": Condition has type void\n";
+        errors += oss.str();
+    }
 }
 
 void SemanticAnalyzer::analyzeFunction(FunctionNode* func) {
     if (!func) return;
     
+    // Declared before the body so that it can call itself
+    returnType = typeFromName(text(func->getReturnType()));
+    if (!symbolTable.addSymbol(func->getName(), SymbolType::FUNCTION, returnType)) {
+        std::ostringstream oss;
+        oss << "Line " << func->getLine() << ": Function '" << text(func->getName()) << "' already declared in this scope\n";
+        errors += oss.str();
+    }
+    
     symbolTable.enterScope();
     
     // Add parameters to symbol table
     for (const auto& param : func->getParams()) {
-        symbolTable.addSymbol(param.second, SymbolType::VARIABLE, param.first);
+        symbolTable.addSymbol(param.name, SymbolType::VARIABLE, typeFromName(text(param.type)));
     }
     
     // Analyze function body
@@ -135,20 +242,24 @@ void SemanticAnalyzer::analyzeFunction(FunctionNode* func) {
     }
     
     symbolTable.exitScope();
+    returnType = TypeId::UNKNOWN;
 }
 
 void SemanticAnalyzer::analyzeVarDecl(VarDeclNode* decl) {
     if (!decl) return;
     
     // Add variable to symbol table
-    if (!symbolTable.addSymbol(decl->getName(), SymbolType::VARIABLE, decl->getVarType())) {
+    TypeId varType = typeFromName(text(decl->getVarType()));
+    if (!symbolTable.addSymbol(decl->getName(), SymbolType::VARIABLE, varType)) {
         std::ostringstream oss;
-        oss << "Line " << decl->getLine() << ": Variable '" << decl->getName() << "' already declared in this scope\n";
+        oss << "Line " << decl->getLine() << ": Variable '" << text(decl->getName()) << "' already declared in this scope\n";
         errors += oss.str();
     }
     
     if (decl->getInitializer()) {
-        analyzeExpression(decl->getInitializer());
+        TypeId value = analyzeExpression(decl->getInitializer());
+        std::string what = "'" + std::string(text(decl->getName())) + "'";
+        checkAssignment(varType, value, decl->getLine(), what);
     }
 }
 
@@ -157,43 +268,42 @@ void SemanticAnalyzer::analyzeAssign(AssignNode* assign) {
     
     // Check if variable exists
     Symbol* sym = symbolTable.lookup(assign->getName());
+    TypeId target = TypeId::UNKNOWN;
     if (!sym) {
         std::ostringstream oss;
-        oss << "Line " << assign->getLine() << ": Assignment to undefined variable '" << assign->getName() << "'\n";
+        oss << "Line " << assign->getLine() << ": Assignment to undefined variable '" << text(assign->getName()) << "'\n";
         errors += oss.str();
+    } else if (sym->type == SymbolType::VARIABLE) {
+        target = sym->dataType;
     }
     
     if (assign->getValue()) {
-        analyzeExpression(assign->getValue());
+        TypeId value = analyzeExpression(assign->getValue());
+        std::string what = "'" + std::string(text(assign->getName())) + "'";
+        checkAssignment(target, value, assign->getLine(), what);
     }
 }
 
 void SemanticAnalyzer::analyzeIf(IfNode* ifNode) {
     if (!ifNode) return;
     
-    analyzeExpression(ifNode->getCondition());
-    symbolTable.enterScope();
+    // analyzeBlock opens the scope of each branch
+    analyzeCondition(ifNode->getCondition());
     if (ifNode->getThenBlock()) {
         analyzeBlock(ifNode->getThenBlock());
     }
-    symbolTable.exitScope();
-    
     if (ifNode->getElseBlock()) {
-        symbolTable.enterScope();
         analyzeBlock(ifNode->getElseBlock());
-        symbolTable.exitScope();
     }
 }
 
 void SemanticAnalyzer::analyzeWhile(WhileNode* whileNode) {
     if (!whileNode) return;
     
-    analyzeExpression(whileNode->getCondition());
-    symbolTable.enterScope();
+    analyzeCondition(whileNode->getCondition());
     if (whileNode->getBody()) {
         analyzeBlock(whileNode->getBody());
     }
-    symbolTable.exitScope();
 }
 
 void SemanticAnalyzer::analyzeFor(ForNode* forNode) {
@@ -205,7 +315,7 @@ void SemanticAnalyzer::analyzeFor(ForNode* forNode) {
         analyzeStatement(forNode->getInit());
     }
     if (forNode->getCondition()) {
-        analyzeExpression(forNode->getCondition());
+        analyzeCondition(forNode->getCondition());
     }
     if (forNode->getIncrement()) {
         analyzeExpression(forNode->getIncrement());
@@ -222,61 +332,43 @@ void SemanticAnalyzer::analyzeBlock(BlockNode* block) {
     
     symbolTable.enterScope();
     
-    for (auto& stmt : block->getStatements()) {
-        analyzeStatement(stmt.get());
+    for (StatementNode* stmt : block->getStatements()) {
+        analyzeStatement(stmt);
     }
     
     symbolTable.exitScope();
 }
 
-void SemanticAnalyzer::analyzeCall(CallNode* call) {
-    if (!call) return;
+void SemanticAnalyzer::analyzeReturn(ReturnNode* returnNode) {
+    if (!returnNode || !returnNode->getValue()) return;
     
-    Symbol* sym = symbolTable.lookup(call->getName());
-    if (!sym || sym->type != SymbolType::FUNCTION) {
+    TypeId value = analyzeExpression(returnNode->getValue());
+    if (returnType == TypeId::VOID) {
         std::ostringstream oss;
-        oss << "Line " << call->getLine() << ": Call to undefined function '" << call->getName() << "'\n";
+        oss << "Line " << returnNode->getLine() << ": Return with a value in a void function\n";
         errors += oss.str();
+        return;
     }
-    
-    // Analyze arguments
-    for (const auto& arg : call->getArgs()) {
-        analyzeExpression(arg.get());
-    }
+    checkAssignment(returnType, value, returnNode->getLine(), "the return value");
 }
 
-std::string SemanticAnalyzer::getExpressionType(ExpressionNode* expr) {
-    if (!expr) return "unknown";
+TypeId SemanticAnalyzer::analyzeCall(CallNode* call) {
+    if (!call) return TypeId::UNKNOWN;
     
-    switch (expr->getType()) {
-        case ASTNode::NODE_LITERAL: {
-            LiteralNode* lit = static_cast<LiteralNode*>(expr);
-            // Extract type from literal node - would need access to private members
-            return "int"; // Simplified
-        }
-        case ASTNode::NODE_IDENTIFIER: {
-            IdentifierNode* id = static_cast<IdentifierNode*>(expr);
-            Symbol* sym = symbolTable.lookup(id->getName());
-            return sym ? sym->dataType : "unknown";
-        }
-        default:
-            return "unknown";
+    TypeId type = TypeId::UNKNOWN;
+    Symbol* sym = symbolTable.lookup(call->getName());
+    if (!sym || sym->type != SymbolType::FUNCTION) {
+        std::ostringstream oss;
+        oss << "Line " << call->getLine() << ": Call to undefined function '" << text(call->getName()) << "'\n";
+        errors += oss.str();
+    } else {
+        type = sym->dataType;
     }
-}
-
-bool SemanticAnalyzer::isConstantExpression(ExpressionNode* expr) {
-    if (!expr) return false;
     
-    return expr->getType() == ASTNode::NODE_LITERAL;
-}
-
-int SemanticAnalyzer::evaluateConstantExpression(ExpressionNode* expr) {
-    if (!isConstantExpression(expr)) {
-        return 0;
+    // Analyze arguments
+    for (ExpressionNode* arg : call->getArgs()) {
+        analyzeExpression(arg);
     }
-    
-    LiteralNode* lit = static_cast<LiteralNode*>(expr);
-    // Would need to parse the literal value
-    return 0; // Simplified
+    return type;
 }
 
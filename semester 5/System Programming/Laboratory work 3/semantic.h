@@ -2,10 +2,11 @@
 #define SEMANTIC_H
 
 #include "ast.h"
+#include "scoped_names.h"
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
-#include <memory>
 
 enum class SymbolType {
     VARIABLE,
@@ -15,39 +16,54 @@ enum class SymbolType {
 
 struct Symbol {
     SymbolType type;
-    std::string name;
-    std::string dataType;
+    SymbolId name;
+    TypeId dataType;                // Resolved once when declared
     bool isDefined;
     
-    Symbol() : type(SymbolType::VARIABLE), isDefined(false) {}
-    Symbol(SymbolType t, const std::string& n, const std::string& dt)
+    Symbol(SymbolType t, SymbolId n, TypeId dt)
         : type(t), name(n), dataType(dt), isDefined(false) {}
 };
 
+// Scoped symbol table keyed by interned names (see ScopedNames). Names
+// declared at the top level go into a scope opened on first use.
 class SymbolTable {
 public:
-    void enterScope();
-    void exitScope();
-    bool addSymbol(const std::string& name, SymbolType type, const std::string& dataType);
-    Symbol* lookup(const std::string& name);
-    bool isInCurrentScope(const std::string& name);
+    // Drops every symbol and scope; nameCount sizes the table for the
+    // interner the names will come from
+    void reset(size_t nameCount) { scopes.reset(nameCount); }
+
+    void enterScope() { scopes.enterScope(); }
+    void exitScope() { scopes.exitScope(); }
+    bool addSymbol(SymbolId name, SymbolType type, TypeId dataType);
+    // The returned pointer is valid until the next addSymbol()
+    Symbol* lookup(SymbolId name) { return scopes.find(name); }
+    bool isInCurrentScope(SymbolId name) const { return scopes.isInCurrentScope(name); }
     
 private:
-    std::vector<std::unordered_map<std::string, Symbol>> scopes;
+    ScopedNames<Symbol> scopes;
 };
 
+// Checks declarations and types. Every expression visited is annotated
+// with its resolved type (ExpressionNode::getResolvedType), so later stages
+// read the type instead of working it out again.
 class SemanticAnalyzer {
 public:
     SemanticAnalyzer();
-    bool analyze(std::vector<std::unique_ptr<StatementNode>>& ast);
+    bool analyze(const TranslationUnit& unit);
     std::string getErrors() const { return errors; }
     
 private:
     SymbolTable symbolTable;
     std::string errors;
+    const StringInterner* names;
+    TypeId returnType;              // Of the function being analyzed
+    
+    std::string_view text(SymbolId id) const { return names->text(id); }
     
     void analyzeStatement(StatementNode* stmt);
-    void analyzeExpression(ExpressionNode* expr);
+    TypeId analyzeExpression(ExpressionNode* expr);
+    TypeId analyzeBinaryOp(BinaryOpNode* binary);
+    TypeId analyzeUnaryOp(UnaryOpNode* unary);
     void analyzeFunction(FunctionNode* func);
     void analyzeVarDecl(VarDeclNode* decl);
     void analyzeAssign(AssignNode* assign);
@@ -55,11 +71,11 @@ private:
     void analyzeWhile(WhileNode* whileNode);
     void analyzeFor(ForNode* forNode);
     void analyzeBlock(BlockNode* block);
-    void analyzeCall(CallNode* call);
+    void analyzeReturn(ReturnNode* returnNode);
+    TypeId analyzeCall(CallNode* call);
+    void analyzeCondition(ExpressionNode* condition);
     
-    std::string getExpressionType(ExpressionNode* expr);
-    bool isConstantExpression(ExpressionNode* expr);
-    int evaluateConstantExpression(ExpressionNode* expr);
+    void checkAssignment(TypeId target, TypeId value, int line, std::string_view what);
 };
 
 #endif // SEMANTIC_H
@@ -0,0 +1,46 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops.
+// parallelFor hands out indices from a shared counter, so fast workers keep
+// taking work while slow ones finish theirs; the calling thread helps too.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    const std::function<void(size_t)>* task;
+    size_t taskCount;
+    std::atomic<size_t> nextIndex;
+    size_t busyWorkers;
+    size_t generation;
+    bool stopping;
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    // threadCount includes the calling thread; 0 uses every hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    // Calls fn(i) for every i in [0, count) and returns when all calls are done
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+};
+
+#endif // THREAD_POOL_H